@@ -10,6 +10,7 @@ private:
     BookingService bookingService;
     
     bool validateBookingInput(const nlohmann::json& data, std::string& error);
+    bool validateHoldInput(const nlohmann::json& data, std::string& error);
 
 public:
     BookingController();
@@ -18,6 +19,12 @@ public:
     Response handleGetBookings(const Request& request);
     Response handleGetBookingById(const Request& request);
     Response handleCancelBooking(const Request& request);
+    Response handleCancelPassengers(const Request& request);
+    Response handleCreateHold(const Request& request);
+    Response handleReleaseHold(const Request& request);
+    Response handlePnrStatus(const Request& request);
+    Response handleJoinQueue(const Request& request);
+    Response handleQueueStatus(const Request& request);
 };
 
 #endif // BOOKINGCONTROLLER_H
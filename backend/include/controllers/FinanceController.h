@@ -0,0 +1,17 @@
+#ifndef FINANCECONTROLLER_H
+#define FINANCECONTROLLER_H
+
+#include "utils/Request.h"
+#include "utils/Response.h"
+
+class FinanceController {
+private:
+    bool hasFinanceAccess(const Request& request);
+
+public:
+    FinanceController();
+    
+    Response handleSummary(const Request& request);
+};
+
+#endif // FINANCECONTROLLER_H
@@ -18,6 +18,8 @@ public:
     TrainController();
     
     Response handleSearch(const Request& request);
+    Response handleFlexibleSearch(const Request& request);
+    Response handleSeatMap(const Request& request);
 };
 
 #endif // TRAINCONTROLLER_H
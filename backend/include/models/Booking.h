@@ -14,9 +14,12 @@ private:
     std::string userId;
     Train train;
     std::string classCode;
+    std::string quota;
     double pricePerPassenger;
     double totalFare;
     std::string journeyDate;
+    std::string boardingStation;  // Empty for the train's origin
+    std::string alightingStation; // Empty for the train's destination
     std::string bookingDate;
     std::string status;
     std::vector<Passenger> passengers;
@@ -32,12 +35,22 @@ public:
     std::string getUserId() const;
     Train getTrain() const;
     std::string getClassCode() const;
+    std::string getQuota() const;
     std::string getStatus() const;
     std::vector<Passenger> getPassengers() const;
+    int getActivePassengerCount() const;
     double getTotalFare() const;
     double getPricePerPassenger() const;
     std::string getJourneyDate() const;
     std::string getBookingDate() const;
+    std::string getBoardingStation() const;
+    std::string getAlightingStation() const;
+    
+    // Stop indices on the train's route; the booking holds legs
+    // [boarding stop, alighting stop)
+    int getBoardingStop() const;
+    int getAlightingStop() const;
+    bool isPartialJourney() const;
     
     // Setters
     void setBookingId(const std::string& id);
@@ -45,10 +58,13 @@ public:
     void addPassenger(const Passenger& passenger);
     void setPassengers(const std::vector<Passenger>& passengers);
     void setJourneyDate(const std::string& date);
+    void setSegment(const std::string& boarding, const std::string& alighting);
     void setStatus(const std::string& status);
+    void setQuota(const std::string& quota);
     void setPricePerPassenger(double price);
     
     // Business Logic
+    double getFareFor(const Passenger& passenger) const;
     void calculateTotalFare();
     std::string generatePnr();
     
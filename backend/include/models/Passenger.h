@@ -12,6 +12,8 @@ private:
     std::string berthPreference;
     std::string assignedSeat;
     std::string assignedBerth;
+    std::string status;
+    double fare; // Negative until priced
 
 public:
     Passenger();
@@ -25,10 +27,15 @@ public:
     std::string getBerthPreference() const;
     std::string getAssignedSeat() const;
     std::string getAssignedBerth() const;
+    std::string getStatus() const;
+    bool isCancelled() const;
+    double getFare() const;
     
     // Setters
     void setAssignedSeat(const std::string& seat);
     void setAssignedBerth(const std::string& berth);
+    void setStatus(const std::string& status);
+    void setFare(double fare);
     
     // Validation
     bool isValid() const;
@@ -36,6 +43,8 @@ public:
     // Serialization
     nlohmann::json toJson() const;
     static Passenger fromJson(const nlohmann::json& json);
+    // Client input: server-owned state (status, fare) is not accepted
+    static Passenger fromRequestJson(const nlohmann::json& json);
 };
 
 #endif // PASSENGER_H
@@ -3,8 +3,26 @@
 
 #include <string>
 #include <vector>
+#include <cstdint>
 #include <nlohmann/json.hpp>
 
+// Travel classes as dense indices for table lookups
+enum class TravelClass : uint8_t {
+    FirstAC,        // 1A
+    SecondAC,       // 2A
+    ThirdAC,        // 3A
+    ThirdEconomy,   // 3E
+    Sleeper,        // SL
+    ChairCar,       // CC
+    ExecutiveChair, // EC
+    SecondSitting,  // 2S
+    Count
+};
+
+const int TRAVEL_CLASS_COUNT = static_cast<int>(TravelClass::Count);
+
+bool parseTravelClass(const std::string& code, TravelClass& travelClass);
+
 class TrainAvailability {
 public:
     std::string classCode;
@@ -27,9 +45,12 @@ private:
     std::string trainName;
     std::string fromStation;
     std::string toStation;
+    std::vector<std::string> viaStations; // Intermediate stops, in running order
     std::string departureTime;
     std::string arrivalTime;
     std::string duration;
+    int durationMinutes;
+    int fareRow; // Row in FareTable, assigned when the table is built
     std::vector<TrainAvailability> availability;
 
 public:
@@ -44,14 +65,27 @@ public:
     std::string getDepartureTime() const;
     std::string getArrivalTime() const;
     std::string getDuration() const;
+    int getDurationMinutes() const;
+    int getFareRow() const;
     std::vector<TrainAvailability> getAvailability() const;
+    const std::vector<TrainAvailability>& getAvailabilityRef() const;
+    
+    // Stops from origin to destination; leg i runs from stop i to stop i + 1
+    std::vector<std::string> getStops() const;
+    int getStopIndex(const std::string& station) const; // -1 if not a stop
+    int getLegCount() const;
+    
+    // Share of the full-route fare charged from stop fromStop to toStop
+    double getSegmentShare(int fromStop, int toStop) const;
     
     // Setters
     void setFromStation(const std::string& from);
     void setToStation(const std::string& to);
+    void setViaStations(const std::vector<std::string>& stations);
     void setDepartureTime(const std::string& time);
     void setArrivalTime(const std::string& time);
     void setDuration(const std::string& duration);
+    void setFareRow(int row);
     void setAvailability(const std::vector<TrainAvailability>& avail);
     void addAvailability(const TrainAvailability& avail);
     
@@ -62,7 +96,21 @@ public:
     
     // Serialization
     nlohmann::json toJson() const;
+    // Search result for travel between two stops: segment stations and
+    // fares. Times are only known end to end and are left out for a part
+    // of the route.
+    nlohmann::json toSegmentJson(int fromStop, int toStop) const;
     static Train fromJson(const nlohmann::json& json);
 };
 
+// Compact per-class projection of a stored train, used by ranking queries
+struct AvailabilityRow {
+    const Train* train;
+    uint16_t classSlot;
+    int availableSeats;
+    int durationMinutes;
+    int departureMinutes;
+    double price;
+};
+
 #endif // TRAIN_H
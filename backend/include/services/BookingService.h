@@ -7,31 +7,90 @@
 #include "models/Train.h"
 #include "models/Booking.h"
 #include "models/Passenger.h"
+#include "utils/SeatHoldManager.h"
+#include "utils/WaitlistManager.h"
 
 class BookingService {
 public:
     BookingService();
     
     // Business Logic
+    // Boarding and alighting stations default to the train's terminals; a
+    // shorter journey is seated from the seat map's free legs
     Booking* createBooking(User* user, 
                           const Train& train,
                           const std::string& classCode,
                           const std::string& journeyDate,
-                          const std::vector<Passenger>& passengers);
+                          const std::vector<Passenger>& passengers,
+                          const std::string& holdId = "",
+                          Quota quota = Quota::General,
+                          const std::string& boardingStation = "",
+                          const std::string& alightingStation = "");
     
     std::vector<Booking> getUserBookings(const std::string& userId,
                                         const std::string& status = "");
     
     bool cancelBooking(const std::string& bookingId, 
-                      const std::string& userId);
+                      const std::string& userId,
+                      double& refundAmount);
+    
+    // Cancels some passengers of a confirmed booking; cancelling all of them
+    // cancels the booking. Refund covers only the passengers cancelled here.
+    bool cancelPassengers(const std::string& bookingId,
+                          const std::string& userId,
+                          const std::vector<int>& passengerIndices,
+                          double& refundAmount,
+                          std::string& error);
     
     double calculateRefund(const Booking& booking);
+    double calculateRefund(double cancelledFare);
+    
+    // Two-phase booking: hold seats during payment, then confirm or release
+    bool holdSeats(User* user,
+                   const Train& train,
+                   const std::string& classCode,
+                   const std::string& journeyDate,
+                   Quota quota,
+                   int seats,
+                   int ttlSeconds,
+                   SeatHold& hold);
+    
+    bool releaseHold(const std::string& holdId, const std::string& userId);
+    
+    // Tatkal opens the day before travel; ladies and senior citizen quotas
+    // require every passenger to qualify
+    bool checkQuotaEligibility(Quota quota,
+                               const std::string& journeyDate,
+                               const std::vector<Passenger>& passengers,
+                               std::string& error);
     
+    // Registered with WaitlistManager. applyPromotion runs inside the queue
+    // critical section; notifyPromotion runs after it, off every lock
+    static bool applyPromotion(const WaitlistPromotion& promotion);
+    static void notifyPromotion(const WaitlistPromotion& promotion);
+
 private:
+    // Fills in each passenger's fare and the booking's adult rate
+    void priceBooking(Booking& booking,
+                      std::vector<Passenger>& passengers,
+                      const Train& train,
+                      Quota quota,
+                      const InventoryCounter* counter);
+    
+    // Part-route bookings: confirmed from seats free on their legs, or not
+    // at all; they take no quota seats and do not join the waitlist
+    Booking* createSegmentBooking(Booking& booking,
+                                  const Train& train,
+                                  const std::vector<Passenger>& passengers);
+    
+    // Returns freed seats to the class; part-route seats count only once
+    // they are free end to end
+    void releaseConfirmedSeats(const Booking& booking,
+                               const std::vector<Passenger>& passengers,
+                               InventoryCounter* counter,
+                               Quota quota);
+    
     bool validateBookingRules(const Booking& booking, std::string& error);
-    bool updateTrainAvailability(const std::string& trainNumber,
-                                const std::string& classCode,
-                                int seatsToDeduct);
     std::string generateBookingId();
 };
 
@@ -0,0 +1,27 @@
+#ifndef BOOKINGWINDOWSERVICE_H
+#define BOOKINGWINDOWSERVICE_H
+
+#include <string>
+#include "utils/Scheduler.h"
+
+// Work tied to the booking calendar: warming the in-memory structures just
+// before a booking window opens, and the chart-time quota spill.
+class BookingWindowService {
+public:
+    BookingWindowService();
+    
+    // Creates the inventory counters, waitlist queues and seat maps of
+    // every class on the journey date and fills the search cache for every
+    // route, so the first requests after opening find them in place.
+    // Returns the classes prepared.
+    int prewarm(const std::string& journeyDate);
+    
+    // Moves unsold special-quota seats to General, RAC and waitlist first,
+    // and stops seat rebalancing for the date. Returns the seats moved.
+    int prepareCharts(const std::string& journeyDate);
+    
+    // Registers the daily jobs at the times in config.json
+    static void scheduleJobs(Scheduler* scheduler);
+};
+
+#endif // BOOKINGWINDOWSERVICE_H
@@ -0,0 +1,46 @@
+#ifndef SEARCHSERVICE_H
+#define SEARCHSERVICE_H
+
+#include <string>
+#include <vector>
+#include <nlohmann/json.hpp>
+#include "models/Train.h"
+
+enum class RankBy {
+    Price,
+    Duration
+};
+
+struct RankedTrain {
+    const Train* train;
+    uint16_t classSlot;
+    int journeyDay;
+    int availableSeats;
+    int durationMinutes;
+    double price;
+};
+
+class SearchService {
+public:
+    SearchService();
+    
+    // /api/search response body; availability is for journeyDate when given
+    nlohmann::json searchRoute(const std::string& from, const std::string& to,
+                               const std::string& journeyDate);
+    
+    // Top-K over a date window: every train contributes its cheapest class
+    // with enough seats on the earliest day in [startDay, startDay + days)
+    std::vector<RankedTrain> findTopTrains(const std::string& from,
+                                           const std::string& to,
+                                           int startDay,
+                                           int days,
+                                           size_t k,
+                                           RankBy rankBy,
+                                           const std::string& classCode = "",
+                                           int seatsRequired = 1);
+    
+private:
+    int seatsOnDate(const AvailabilityRow& row, const std::string& journeyDate);
+};
+
+#endif // SEARCHSERVICE_H
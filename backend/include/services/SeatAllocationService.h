@@ -3,22 +3,67 @@
 
 #include <string>
 #include <vector>
+#include <nlohmann/json.hpp>
 #include "models/Passenger.h"
+#include "models/Train.h"
+#include "utils/SeatMap.h"
 
 class SeatAllocationService {
 public:
     SeatAllocationService();
     
     // Seat Assignment Logic
+    // Claims real seats from the class's seat map for the journey date,
+    // honouring each passenger's berth preference where one is free;
+    // false when the map has fewer free seats than passengers
     bool assignSeats(std::vector<Passenger>& passengers, 
-                    const std::string& classCode,
-                    const std::string& trainNumber);
+                    const Train& train,
+                    const std::string& journeyDate,
+                    const std::string& classCode);
     
+    // Seats for part of the route, stops fromStop to toStop. freshSeats is
+    // how many were free end to end and must be taken from the class count.
+    bool assignSegmentSeats(std::vector<Passenger>& passengers,
+                            const Train& train,
+                            const std::string& journeyDate,
+                            const std::string& classCode,
+                            int fromStop,
+                            int toStop,
+                            int& freshSeats);
+    
+    // Frees the seats of the given passengers; RAC/WL labels are ignored
+    void releaseSeats(const std::vector<Passenger>& passengers,
+                      const Train& train,
+                      const std::string& journeyDate,
+                      const std::string& classCode);
+    
+    // Frees part-route seats; returns how many are now free end to end
+    int releaseSegmentSeats(const std::vector<Passenger>& passengers,
+                            const Train& train,
+                            const std::string& journeyDate,
+                            const std::string& classCode,
+                            int fromStop,
+                            int toStop);
+    
+    // Moves a confirmed booking's seats to leave more whole bays free: a
+    // party split across bays is regrouped, a single passenger moves to a
+    // berth of the same type in a fuller bay. True when the stored booking now holds the new seats.
+    bool rebalanceBooking(const std::string& bookingId);
+    
+    // Occupancy for the booking UI: one base64 bitset per coach, a set bit
+    // a seat taken between the two stops, and the layout to draw it with.
+    // Null when the train has no such class.
+    nlohmann::json describeSeatMap(const Train& train,
+                                   const std::string& journeyDate,
+                                   const std::string& classCode,
+                                   int fromStop,
+                                   int toStop);
+
 private:
-    std::string generateCoachPrefix(const std::string& classCode);
-    int getRandomCoachNumber();
-    std::string getBerthType(int seatNumber, const std::string& classCode);
-    int nextSeatNumber;
+    void labelSeats(std::vector<Passenger>& passengers,
+                    const std::vector<SeatRef>& seats,
+                    const CoachLayout& layout);
+    bool parseSeatLabel(const std::string& label, SeatRef& seat);
 };
 
 #endif // SEATALLOCATIONSERVICE_H
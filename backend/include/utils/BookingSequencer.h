@@ -0,0 +1,85 @@
+#ifndef BOOKINGSEQUENCER_H
+#define BOOKINGSEQUENCER_H
+
+#include <string>
+#include <atomic>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#include <future>
+#include <memory>
+#include <vector>
+
+// Lock-free multi-producer single-consumer queue (Vyukov). Producers never
+// block each other; the single consumer pops in FIFO order.
+class MpscTaskQueue {
+public:
+    struct Node {
+        std::atomic<Node*> next;
+        std::function<void()> task;
+    };
+    
+    MpscTaskQueue();
+    
+    void push(Node* node);
+    Node* pop(); // nullptr when empty or a push is mid-flight
+    
+private:
+    alignas(64) std::atomic<Node*> head;
+    alignas(64) Node* tail;
+    Node stub;
+};
+
+// Routes booking mutations for a train to a single writer thread per shard.
+// Requests for one train are applied in arrival order, drained in batches,
+// and never contend with each other on inventory or seat-map locks.
+class BookingSequencer {
+private:
+    static const size_t SHARD_COUNT = 8;
+    static const size_t BATCH_SIZE = 64;
+    
+    struct Shard {
+        MpscTaskQueue queue;
+        std::atomic<size_t> pending;
+        std::atomic<bool> sleeping;
+        std::mutex sleepMutex;
+        std::condition_variable wakeup;
+        std::thread worker;
+        
+        Shard() : pending(0), sleeping(false) {}
+    };
+    
+    std::unique_ptr<Shard> shards[SHARD_COUNT];
+    std::atomic<bool> stopping;
+    
+    // Singleton
+    BookingSequencer();
+    ~BookingSequencer();
+    
+    void runShard(Shard& shard);
+    void submit(const std::string& trainNumber, std::function<void()> task);
+
+public:
+    static BookingSequencer* getInstance();
+    
+    // Runs work on the train's sequencer and blocks until it has completed
+    template <typename Result>
+    Result execute(const std::string& trainNumber, std::function<Result()> work) {
+        // The task owns the promise so it outlives the waiting handler's wakeup
+        auto promise = std::make_shared<std::promise<Result>>();
+        std::future<Result> future = promise->get_future();
+        
+        submit(trainNumber, [promise, work]() {
+            try {
+                promise->set_value(work());
+            } catch (...) {
+                promise->set_exception(std::current_exception());
+            }
+        });
+        
+        return future.get();
+    }
+};
+
+#endif // BOOKINGSEQUENCER_H
@@ -0,0 +1,130 @@
+#ifndef COACHLAYOUT_H
+#define COACHLAYOUT_H
+
+#include <string>
+#include <array>
+#include <utility>
+#include <cstdint>
+#include "models/Train.h"
+
+enum class BerthType : uint8_t {
+    Lower,
+    Middle,
+    Upper,
+    SideLower,
+    SideUpper,
+    Seat, // Chair car seating
+    Count
+};
+
+const int BERTH_TYPE_COUNT = static_cast<int>(BerthType::Count);
+
+// Berth preference as sent by the UI; false for "No Choice" and unknown values
+bool parseBerthType(const std::string& name, BerthType& type);
+const char* berthTypeName(BerthType type);
+
+// Berth types repeat every bayLength seats along the coach. A party is
+// kept within baySeats: a compartment, cabin or row of seats.
+struct CoachLayout {
+    const char* id;          // Stable name clients draw the coach from
+    const char* coachPrefix; // "B" in B3-41
+    int seatsPerCoach;
+    int bayLength;
+    BerthType bay[8];
+    int baySeats;
+    
+    constexpr BerthType berthAt(int seat) const { return bay[(seat - 1) % bayLength]; }
+};
+
+// One specialization per travel class; a class without one does not compile
+template <TravelClass C>
+struct ClassLayout;
+
+template <>
+struct ClassLayout<TravelClass::FirstAC> {
+    static constexpr CoachLayout value = {
+        "1A-24", "H", 24, 2, {BerthType::Lower, BerthType::Upper}, 4
+    };
+};
+
+template <>
+struct ClassLayout<TravelClass::SecondAC> {
+    static constexpr CoachLayout value = {
+        "2A-48", "A", 48, 6,
+        {BerthType::Lower, BerthType::Upper, BerthType::Lower, BerthType::Upper,
+         BerthType::SideLower, BerthType::SideUpper},
+        6
+    };
+};
+
+template <>
+struct ClassLayout<TravelClass::ThirdAC> {
+    static constexpr CoachLayout value = {
+        "3A-64", "B", 64, 8,
+        {BerthType::Lower, BerthType::Middle, BerthType::Upper, BerthType::Lower,
+         BerthType::Middle, BerthType::Upper, BerthType::SideLower, BerthType::SideUpper},
+        8
+    };
+};
+
+template <>
+struct ClassLayout<TravelClass::ThirdEconomy> {
+    static constexpr CoachLayout value = {
+        "3E-72", "M", 72, 8,
+        {BerthType::Lower, BerthType::Middle, BerthType::Upper, BerthType::Lower,
+         BerthType::Middle, BerthType::Upper, BerthType::SideLower, BerthType::SideUpper},
+        8
+    };
+};
+
+template <>
+struct ClassLayout<TravelClass::Sleeper> {
+    static constexpr CoachLayout value = {
+        "SL-72", "S", 72, 8,
+        {BerthType::Lower, BerthType::Middle, BerthType::Upper, BerthType::Lower,
+         BerthType::Middle, BerthType::Upper, BerthType::SideLower, BerthType::SideUpper},
+        8
+    };
+};
+
+template <>
+struct ClassLayout<TravelClass::ChairCar> {
+    static constexpr CoachLayout value = {"CC-78", "C", 78, 1, {BerthType::Seat}, 5};
+};
+
+template <>
+struct ClassLayout<TravelClass::ExecutiveChair> {
+    static constexpr CoachLayout value = {"EC-56", "E", 56, 1, {BerthType::Seat}, 4};
+};
+
+template <>
+struct ClassLayout<TravelClass::SecondSitting> {
+    static constexpr CoachLayout value = {"2S-108", "D", 108, 1, {BerthType::Seat}, 6};
+};
+
+template <size_t... I>
+constexpr std::array<CoachLayout, TRAVEL_CLASS_COUNT> makeCoachLayouts(std::index_sequence<I...>) {
+    return {{ClassLayout<static_cast<TravelClass>(I)>::value...}};
+}
+
+// Indexed by TravelClass
+inline constexpr std::array<CoachLayout, TRAVEL_CLASS_COUNT> COACH_LAYOUTS =
+    makeCoachLayouts(std::make_index_sequence<TRAVEL_CLASS_COUNT>());
+
+constexpr bool coachLayoutsFit() {
+    for (const CoachLayout& layout : COACH_LAYOUTS) {
+        if (layout.seatsPerCoach < 1 || layout.seatsPerCoach > 128 ||
+            layout.bayLength < 1 || layout.bayLength > 8 || layout.baySeats < 4) {
+            return false;
+        }
+    }
+    return true;
+}
+
+static_assert(coachLayoutsFit(), "Coach layouts must fit the seat map's 128-seat coaches");
+
+constexpr const CoachLayout& coachLayout(TravelClass travelClass) {
+    return COACH_LAYOUTS[static_cast<size_t>(travelClass)];
+}
+
+#endif // COACHLAYOUT_H
@@ -0,0 +1,28 @@
+#ifndef CONFIG_H
+#define CONFIG_H
+
+#include <string>
+#include <nlohmann/json.hpp>
+
+// Read-only view of config.json. Keys are JSON pointers such as
+// "/security/tokenExpiry"; missing keys fall back to the given default.
+class Config {
+private:
+    nlohmann::json values;
+    
+    // Singleton
+    static Config* instance;
+    Config();
+
+public:
+    static Config* getInstance();
+    
+    bool load(const std::string& path);
+    
+    int getInt(const std::string& key, int defaultValue) const;
+    double getDouble(const std::string& key, double defaultValue) const;
+    bool getBool(const std::string& key, bool defaultValue) const;
+    std::string getString(const std::string& key, const std::string& defaultValue) const;
+};
+
+#endif // CONFIG_H
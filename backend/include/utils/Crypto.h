@@ -0,0 +1,39 @@
+#ifndef CRYPTO_H
+#define CRYPTO_H
+
+#include <string>
+
+typedef struct evp_md_ctx_st EVP_MD_CTX;
+
+namespace Crypto {
+    // HMAC-SHA256 of data, hex encoded
+    std::string hmacSha256Hex(const std::string& key, const std::string& data);
+    
+    // Same MAC for a key that signs many messages: the key's inner and
+    // outer pads are hashed once, each message only copies those states.
+    // Safe to use from several threads.
+    class HmacSha256 {
+    private:
+        EVP_MD_CTX* inner;
+        EVP_MD_CTX* outer;
+    
+    public:
+        explicit HmacSha256(const std::string& key);
+        ~HmacSha256();
+        HmacSha256(const HmacSha256&) = delete;
+        HmacSha256& operator=(const HmacSha256&) = delete;
+        
+        std::string hex(const std::string& data) const;
+    };
+    
+    // Comparison whose running time does not depend on where inputs differ
+    bool constantTimeEquals(const std::string& a, const std::string& b);
+    
+    // Cryptographically random bytes from OpenSSL
+    std::string randomBytes(size_t count);
+    
+    // Standard base64 with padding
+    std::string base64Encode(const unsigned char* data, size_t length);
+}
+
+#endif // CRYPTO_H
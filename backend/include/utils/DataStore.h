@@ -4,13 +4,21 @@
 #include <string>
 #include <unordered_map>
 #include <vector>
+#include <deque>
 #include <mutex>
+#include <ctime>
+#include <functional>
 #include "models/User.h"
 #include "models/Train.h"
 #include "models/Booking.h"
 
 class DataStore {
 private:
+    struct Session {
+        std::string userId;
+        std::time_t expiresAt;
+    };
+    
     // Storage containers
     std::unordered_map<std::string, User> usersByEmail;
     std::unordered_map<std::string, User> usersById;
@@ -19,7 +27,15 @@ private:
     std::unordered_map<std::string, Booking> bookingsById;
     std::unordered_map<std::string, std::vector<std::string>> bookingsByUser;
     std::unordered_map<std::string, std::string> pnrToBookingId;
-    std::unordered_map<std::string, std::string> activeSessions;
+    std::unordered_map<std::string, Session> activeSessions;
+    
+    // Every session gets the same TTL, so login order is expiry order and
+    // the sweep only ever pops from the front. Entries of logged-out or
+    // re-issued tokens are stale; they are skipped when they reach the
+    // front, and compacted away once they make up half the queue.
+    std::deque<std::pair<std::time_t, std::string>> sessionExpiry;
+    int sessionTtlSeconds;
+    size_t maxSessions;
     
     // Thread safety
     std::mutex userMutex;
@@ -30,6 +46,8 @@ private:
     // Singleton
     static DataStore* instance;
     DataStore();
+    
+    void sweepSessionsLocked(std::time_t now);
 
 public:
     static DataStore* getInstance();
@@ -45,7 +63,11 @@ public:
     bool addTrain(const Train& train);
     Train* findTrainByNumber(const std::string& trainNumber);
     std::vector<Train> searchTrains(const std::string& from, const std::string& to);
+    std::vector<AvailabilityRow> getRouteAvailabilityRows(const std::string& from, 
+                                                          const std::string& to);
+    std::vector<std::pair<std::string, std::string>> getRoutes();
     bool updateTrain(const Train& train);
+    void forEachTrain(const std::function<void(Train&)>& visitor);
     
     // Booking Operations
     bool addBooking(const Booking& booking);
@@ -53,11 +75,19 @@ public:
     Booking* findBookingByPnr(const std::string& pnr);
     std::vector<Booking> findBookingsByUser(const std::string& userId);
     bool updateBooking(const Booking& booking);
+    bool modifyBooking(const std::string& bookingId, 
+                       const std::function<void(Booking&)>& mutator);
+    bool transitionBookingStatus(const std::string& bookingId, 
+                                 const std::string& newStatus,
+                                 std::string& previousStatus);
     bool deleteBooking(const std::string& bookingId);
+    void forEachBooking(const std::function<void(const Booking&)>& visitor);
     
     // Session Operations
+    // Sessions last security.tokenExpiry seconds; past security.maxSessions
+    // the oldest are dropped first
     void addSession(const std::string& token, const std::string& userId);
-    std::string getUserIdFromToken(const std::string& token);
+    std::string getUserIdFromToken(const std::string& token); // Empty once expired
     void removeSession(const std::string& token);
     
     // Initialize with sample data
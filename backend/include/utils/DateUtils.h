@@ -0,0 +1,17 @@
+#ifndef DATEUTILS_H
+#define DATEUTILS_H
+
+#include <string>
+
+namespace DateUtils {
+    // Calendar dates are handled as day numbers (days since 1970-01-01)
+    bool parseDate(const std::string& date, int& dayNumber);
+    std::string formatDate(int dayNumber);
+    int today();
+    
+    // "15h 35m" -> 935, "06:45" -> 405; -1 when malformed
+    int parseDurationMinutes(const std::string& duration);
+    int parseClockMinutes(const std::string& time);
+}
+
+#endif // DATEUTILS_H
@@ -0,0 +1,124 @@
+#ifndef EVENTBUS_H
+#define EVENTBUS_H
+
+#include <string>
+#include <vector>
+#include <memory>
+#include <atomic>
+#include <thread>
+#include <functional>
+#include <mutex>
+#include <condition_variable>
+#include <cstdint>
+#include "models/Booking.h"
+
+enum class BookingEventType : uint8_t {
+    BookingCreated,
+    BookingUpdated,
+    BookingCancelled,
+    SeatsReserved,
+    SeatsReleased
+};
+
+// Fixed-size, trivially copyable snapshot so events can be copied out of the
+// ring without locks. Strings are truncated to their field widths.
+struct BookingEvent {
+    static const int MAX_PASSENGERS = 6;
+    
+    struct PassengerState {
+        char seat[12];
+        char berth[20];
+        bool cancelled;
+    };
+    
+    uint64_t sequence;
+    int64_t timestampMs;
+    BookingEventType type;
+    char bookingId[24];
+    char pnr[16];
+    char userId[32];
+    char trainNumber[8];
+    char journeyDate[12];
+    char classCode[4];
+    char quota[4];
+    char status[12];
+    int32_t seats;          // Passengers, or seats reserved/released
+    int32_t available;      // General seats left after an inventory change
+    double totalFare;
+    uint8_t passengerCount;
+    PassengerState passengers[MAX_PASSENGERS];
+    
+    static BookingEvent forBooking(BookingEventType type, const Booking& booking);
+    static BookingEvent forInventory(BookingEventType type, const std::string& trainNumber,
+                                     const std::string& journeyDate, const std::string& classCode,
+                                     int seats, int available);
+};
+
+// Broadcast ring of booking events. Producers claim a sequence with one
+// fetch_add, then take its slot with a CAS on the slot's stamp, so two
+// producers a lap apart never write the same slot at once. Every consumer
+// keeps its own cursor; one that falls more than a ring behind skips ahead
+// and counts what it lost instead of slowing producers down. Idle consumers
+// sleep on a condition variable that producers signal only when one is
+// waiting.
+class EventBus {
+public:
+    using Handler = std::function<void(const BookingEvent&)>;
+    using LostHandler = std::function<void(uint64_t lostCount)>;
+
+private:
+    struct alignas(64) Slot {
+        std::atomic<uint64_t> stamp; // 2*seq+1 while writing, 2*seq+2 once published
+        BookingEvent event;
+    };
+    
+    struct Subscription {
+        std::string name;
+        Handler handler;
+        LostHandler onLost;
+        std::thread worker;
+        std::atomic<uint64_t> lost;
+    };
+    
+    size_t capacity;
+    size_t mask;
+    std::unique_ptr<Slot[]> slots;
+    std::atomic<uint64_t> nextSequence;
+    
+    std::mutex subscriptionMutex;
+    std::vector<std::unique_ptr<Subscription>> subscriptions;
+    std::atomic<bool> stopping;
+    
+    std::mutex idleMutex;
+    std::condition_variable idleCv;
+    std::atomic<int> idleConsumers;
+    
+    // Singleton
+    EventBus();
+    ~EventBus();
+    
+    void runSubscription(Subscription* subscription, uint64_t cursor);
+    bool hasEvent(uint64_t cursor) const;
+    void waitForEvent(uint64_t cursor);
+
+public:
+    static EventBus* getInstance();
+    
+    void publish(BookingEvent event);
+    
+    // Sequence the next published event will get; new cursors start here
+    uint64_t getHeadSequence() const;
+    
+    // Reads the event at cursor and advances it. Returns false if nothing is
+    // published there yet. If the cursor was lapped it jumps to the oldest
+    // readable event and adds the skipped count to lost.
+    bool poll(uint64_t& cursor, BookingEvent& event, uint64_t& lost) const;
+    
+    // Runs handler on its own thread for every event published from now on.
+    // onLost runs on the same thread when the consumer had to skip events.
+    void subscribe(const std::string& name, Handler handler, LostHandler onLost = nullptr);
+    
+    uint64_t getLostCount(const std::string& name);
+};
+
+#endif // EVENTBUS_H
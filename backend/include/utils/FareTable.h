@@ -0,0 +1,55 @@
+#ifndef FARETABLE_H
+#define FARETABLE_H
+
+#include <vector>
+#include <cstdint>
+#include "models/Train.h"
+#include "utils/SeatInventory.h"
+
+// Read-only fare lookup tables built once at startup. Base fares are laid
+// out per (train, class, distance band, quota); age concessions and demand
+// surcharges are small side tables, so pricing a passenger is three array
+// reads and two multiplies.
+class FareTable {
+public:
+    static const int DISTANCE_BAND_COUNT = 6;
+    static const int MAX_AGE = 120;
+    static const int SURGE_BUCKET_COUNT = 11; // Tenths of the class sold, 0-10
+
+private:
+    std::vector<double> baseFares; // Negative where the class is not offered
+    std::vector<uint8_t> trainBands;
+    double concessions[QUOTA_COUNT][MAX_AGE + 1];
+    double surgeMultipliers[SURGE_BUCKET_COUNT];
+    
+    // Singleton
+    FareTable();
+    
+    static size_t indexOf(int fareRow, TravelClass travelClass, int band, Quota quota);
+    static double tatkalFare(TravelClass travelClass, double baseFare);
+    void buildConcessions();
+    void buildSurge();
+
+public:
+    static FareTable* getInstance();
+    
+    // Assigns every stored train a fare row and fills the tables
+    void build();
+    
+    static int estimateDistanceKm(int durationMinutes);
+    static int distanceBand(int distanceKm);
+    static int surgeBucket(const InventoryCounter* counter);
+    
+    // Adult fare for a whole band, or negative if there is none
+    double baseFare(int fareRow, TravelClass travelClass, int band, Quota quota) const;
+    
+    // Adult fare for the train's own end-to-end journey
+    double baseFare(const Train& train, TravelClass travelClass, Quota quota) const;
+    
+    double surgeMultiplier(int surgeBucket) const;
+    
+    // Final fare for one passenger, rounded to whole rupees
+    double passengerFare(double baseFare, Quota quota, int age, int surgeBucket) const;
+};
+
+#endif // FARETABLE_H
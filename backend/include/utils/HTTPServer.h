@@ -25,6 +25,12 @@ public:
 private:
     void setupCORS();
     Request parseHttplibRequest(const httplib::Request& req);
+    bool admitFromWaitingRoom(const httplib::Request& req, httplib::Response& res,
+                              uint64_t& queueTicket);
+    bool spendQueueTicket(const httplib::Request& req, httplib::Response& res,
+                          uint64_t queueTicket);
+    bool beginIdempotentRequest(const httplib::Request& req, httplib::Response& res, 
+                                std::string& storeKey);
 };
 
 #endif // HTTPSERVER_H
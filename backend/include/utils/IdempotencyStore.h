@@ -0,0 +1,63 @@
+#ifndef IDEMPOTENCYSTORE_H
+#define IDEMPOTENCYSTORE_H
+
+#include <string>
+#include <unordered_map>
+#include <deque>
+#include <mutex>
+#include <chrono>
+
+enum class IdempotencyState {
+    Started,    // First time this key is seen; caller must complete or abandon
+    InFlight,   // An earlier request with this key is still running
+    Replay,     // Stored response is returned in place of running again
+    Mismatch,   // Key was reused with a different request body
+    Full        // No room for a new key until in-flight requests finish
+};
+
+struct StoredResponse {
+    int statusCode;
+    std::string body;
+};
+
+// Bounded dedupe table for retried POSTs keyed by the Idempotency-Key header.
+// Every entry lives for the same TTL, so each shard evicts in insertion order.
+// Over the size cap only completed entries are dropped early; an in-flight
+// entry is kept until it completes or expires so a retry cannot run twice.
+class IdempotencyStore {
+private:
+    static const int SHARD_COUNT = 16;
+    
+    struct Entry {
+        bool completed;
+        size_t requestHash;
+        StoredResponse response;
+        std::chrono::steady_clock::time_point createdAt;
+    };
+    
+    struct Shard {
+        std::mutex mutex;
+        std::unordered_map<std::string, Entry> entries;
+        std::deque<std::pair<std::string, std::chrono::steady_clock::time_point>> order;
+    };
+    
+    Shard shards[SHARD_COUNT];
+    std::chrono::seconds ttl;
+    size_t maxEntriesPerShard;
+    
+    // Singleton
+    IdempotencyStore();
+    
+    Shard& shardFor(const std::string& key);
+    void evictLocked(Shard& shard, std::chrono::steady_clock::time_point now);
+
+public:
+    static IdempotencyStore* getInstance();
+    
+    IdempotencyState begin(const std::string& key, const std::string& requestBody, 
+                           StoredResponse& stored);
+    void complete(const std::string& key, int statusCode, const std::string& body);
+    void abandon(const std::string& key);
+};
+
+#endif // IDEMPOTENCYSTORE_H
@@ -0,0 +1,104 @@
+#ifndef LEDGER_H
+#define LEDGER_H
+
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <memory>
+#include <atomic>
+#include <mutex>
+#include <shared_mutex>
+#include <thread>
+#include <condition_variable>
+#include <fstream>
+#include <cstdint>
+#include <nlohmann/json.hpp>
+#include "models/Booking.h"
+
+enum class LedgerEntryType : uint8_t {
+    Fare,
+    Refund
+};
+
+struct LedgerEntry {
+    int64_t timestampMs;
+    LedgerEntryType type;
+    char bookingId[24];
+    char userId[32];
+    char trainNumber[8];
+    double amount;
+    
+    nlohmann::json toJson() const;
+};
+
+struct LedgerTotals {
+    double fares;
+    double refunds;
+    int fareEntries;
+    int refundEntries;
+    
+    LedgerTotals();
+    void add(const LedgerEntry& entry);
+    nlohmann::json toJson() const;
+};
+
+// Append-only record of fares collected and refunds paid. Request threads
+// write into their own single-producer buffers without locking; a background
+// thread drains them in batches, appends them to the journal file and folds
+// them into per-train, per-day and per-user totals for finance queries.
+class Ledger {
+private:
+    static const size_t BUFFER_CAPACITY = 1024;
+    
+    struct ThreadBuffer {
+        LedgerEntry entries[BUFFER_CAPACITY];
+        std::atomic<size_t> head; // Next slot the owning thread writes
+        std::atomic<size_t> tail; // Next slot the aggregator reads
+        
+        ThreadBuffer();
+    };
+    
+    std::mutex registryMutex;
+    std::vector<std::unique_ptr<ThreadBuffer>> buffers;
+    
+    // Entries from a thread whose buffer was full
+    std::mutex overflowMutex;
+    std::vector<LedgerEntry> overflow;
+    
+    std::ofstream journalFile; // data/ledger.jsonl, when storage.persistToFile is set
+    
+    mutable std::shared_mutex totalsMutex;
+    LedgerTotals overall;
+    std::unordered_map<std::string, LedgerTotals> byTrain;
+    std::unordered_map<std::string, LedgerTotals> byDay;
+    std::unordered_map<std::string, LedgerTotals> byUser;
+    
+    std::mutex aggregateMutex;
+    std::thread aggregator;
+    std::condition_variable aggregatorCv;
+    std::mutex aggregatorWaitMutex;
+    bool stopping;
+    int intervalMs;
+    
+    // Singleton
+    Ledger();
+    ~Ledger();
+    
+    ThreadBuffer* localBuffer();
+    void runAggregator();
+
+public:
+    static Ledger* getInstance();
+    
+    void record(LedgerEntryType type, const Booking& booking, double amount);
+    
+    // Drains every buffer and updates the totals; runs periodically
+    void aggregate();
+    
+    LedgerTotals getOverallTotals() const;
+    bool getTrainTotals(const std::string& trainNumber, LedgerTotals& totals) const;
+    bool getDayTotals(const std::string& date, LedgerTotals& totals) const;
+    bool getUserTotals(const std::string& userId, LedgerTotals& totals) const;
+};
+
+#endif // LEDGER_H
@@ -0,0 +1,91 @@
+#ifndef NOTIFICATIONOUTBOX_H
+#define NOTIFICATIONOUTBOX_H
+
+#include <string>
+#include <vector>
+#include <deque>
+#include <memory>
+#include <atomic>
+#include <mutex>
+#include <thread>
+#include <condition_variable>
+#include <fstream>
+#include <cstdint>
+#include <nlohmann/json.hpp>
+#include "models/Booking.h"
+#include "utils/NotificationSink.h"
+
+enum class NotificationType : uint8_t {
+    BookingConfirmed,
+    BookingCancelled,
+    PassengersCancelled
+};
+
+// What the customer is told, captured when the booking changed
+struct Notification {
+    uint64_t id;
+    NotificationType type;
+    int64_t createdMs;
+    std::string bookingId;
+    std::string pnr;
+    std::string userId;
+    std::string trainNumber;
+    std::string journeyDate;
+    std::string classCode;
+    std::string status;
+    double totalFare;
+    double refundAmount;
+    std::vector<std::string> passengerStatuses; // "CNF B1-23 Lower", "CAN", ...
+    
+    nlohmann::json toJson() const;
+    static bool fromJson(const nlohmann::json& json, Notification& notification);
+};
+
+// Outbox for booking notifications. Request threads only append a record;
+// a dispatcher thread renders SMS and email messages and hands them to the
+// sink in batches, retrying with backoff while the sink fails. With
+// storage.persistToFile the outbox is journaled, so undelivered records
+// survive a restart and are sent then.
+class NotificationOutbox {
+private:
+    std::deque<Notification> pending;
+    uint64_t nextId;
+    std::ofstream journalFile;
+    std::string journalPath;
+    std::mutex outboxMutex;
+    
+    std::unique_ptr<NotificationSink> sink;
+    std::atomic<uint64_t> deliveredCount;
+    
+    std::thread dispatcher;
+    std::condition_variable dispatchCv;
+    bool stopping;
+    bool enabled;
+    size_t batchSize;
+    int batchIntervalMs;
+    int maxRetryDelayMs;
+    
+    // Singleton
+    NotificationOutbox();
+    ~NotificationOutbox();
+    
+    void replayJournal();
+    void runDispatcher();
+    std::vector<NotificationMessage> render(const std::vector<Notification>& batch);
+
+public:
+    static NotificationOutbox* getInstance();
+    
+    // Takes ownership; call before start
+    void setSink(std::unique_ptr<NotificationSink> sink);
+    
+    // Restores undelivered records from the journal and starts dispatching
+    void start();
+    
+    void enqueue(NotificationType type, const Booking& booking, double refundAmount = 0.0);
+    
+    size_t getPendingCount();
+    uint64_t getDeliveredCount() const;
+};
+
+#endif // NOTIFICATIONOUTBOX_H
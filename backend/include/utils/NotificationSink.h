@@ -0,0 +1,44 @@
+#ifndef NOTIFICATIONSINK_H
+#define NOTIFICATIONSINK_H
+
+#include <string>
+#include <vector>
+#include <fstream>
+#include <mutex>
+#include <cstdint>
+#include <nlohmann/json.hpp>
+
+// One rendered SMS or email, ready for a delivery provider
+struct NotificationMessage {
+    uint64_t notificationId;
+    std::string channel; // "sms" or "email"
+    std::string recipient;
+    std::string subject;
+    std::string body;
+    
+    nlohmann::json toJson() const;
+};
+
+// Delivery backend for the notification outbox. deliver() gets a whole
+// batch; returning false leaves the batch in the outbox to be retried, so
+// a sink may see the same message more than once.
+class NotificationSink {
+public:
+    virtual ~NotificationSink() {}
+    virtual bool deliver(const std::vector<NotificationMessage>& messages) = 0;
+};
+
+// Appends messages as JSON lines to a local file, for development and tests
+class FileNotificationSink : public NotificationSink {
+private:
+    std::string path;
+    std::ofstream file;
+    std::mutex fileMutex;
+
+public:
+    explicit FileNotificationSink(const std::string& path);
+    
+    bool deliver(const std::vector<NotificationMessage>& messages) override;
+};
+
+#endif // NOTIFICATIONSINK_H
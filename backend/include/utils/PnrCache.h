@@ -0,0 +1,46 @@
+#ifndef PNRCACHE_H
+#define PNRCACHE_H
+
+#include <string>
+#include <unordered_map>
+#include <shared_mutex>
+#include <cstdint>
+#include "utils/EventBus.h"
+
+// Read-optimized PNR status projections, keyed by the PNR as an integer
+// ("123-4567890" -> 1234567890) and stored as ready-to-send JSON. Kept up
+// to date by an EventBus consumer, so lookups never touch the booking store.
+class PnrCache {
+private:
+    static const size_t SHARD_COUNT = 64;
+    
+    struct alignas(64) Shard {
+        std::shared_mutex mutex;
+        std::unordered_map<uint64_t, std::string> statuses;
+    };
+    
+    Shard shards[SHARD_COUNT];
+    
+    // Singleton
+    PnrCache();
+    
+    Shard& shardFor(uint64_t key);
+    void apply(const BookingEvent& event);
+    void rebuild();
+    static std::string buildStatus(const BookingEvent& event);
+
+public:
+    static PnrCache* getInstance();
+    
+    // Accepts "123-4567890" or "1234567890"
+    static bool encodePnr(const std::string& pnr, uint64_t& key);
+    
+    // Subscribes to the event bus; call once at startup
+    void start();
+    
+    bool lookup(uint64_t key, std::string& statusJson);
+    
+    size_t size();
+};
+
+#endif // PNRCACHE_H
@@ -10,12 +10,14 @@ public:
     int statusCode;
     std::map<std::string, std::string> headers;
     nlohmann::json body;
+    std::string rawBody; // Pre-serialized JSON; sent instead of body when set
     
     Response(int code = 200);
     
     void setJson(const nlohmann::json& json);
     void setError(const std::string& message, int code = 400);
     void setSuccess(const nlohmann::json& data, const std::string& message = "");
+    void setRaw(const std::string& json);
     std::string toString() const;
     std::string toHttpResponse() const;
 };
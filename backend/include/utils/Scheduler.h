@@ -0,0 +1,65 @@
+#ifndef SCHEDULER_H
+#define SCHEDULER_H
+
+#include <string>
+#include <vector>
+#include <queue>
+#include <mutex>
+#include <thread>
+#include <condition_variable>
+#include <functional>
+#include <ctime>
+
+// Runs registered jobs once a day at a wall-clock time. Times are "HH:MM" in
+// the railway's local zone (scheduler.utcOffsetMinutes, IST by default).
+// Jobs run one at a time on a single background thread, so a slow job
+// delays the next one rather than overlapping it.
+class Scheduler {
+public:
+    using Job = std::function<void()>;
+
+private:
+    struct Entry {
+        std::string name;
+        int minuteOfDay;
+        Job job;
+    };
+    
+    struct Due {
+        std::time_t runAt;
+        size_t entryIndex;
+        
+        bool operator>(const Due& other) const { return runAt > other.runAt; }
+    };
+    
+    std::vector<Entry> entries;
+    std::priority_queue<Due, std::vector<Due>, std::greater<Due>> due;
+    int utcOffsetMinutes;
+    
+    std::mutex scheduleMutex;
+    std::condition_variable scheduleCv;
+    std::thread worker;
+    bool stopping;
+    
+    // Singleton
+    Scheduler();
+    ~Scheduler();
+    
+    void run();
+    std::time_t nextRun(int minuteOfDay, std::time_t after) const;
+
+public:
+    static Scheduler* getInstance();
+    
+    // Returns false if the time is not a valid "HH:MM"
+    bool scheduleDaily(const std::string& name, const std::string& clockTime, Job job);
+    
+    // Starts the worker thread; call once after registering the jobs
+    void start();
+    
+    // Local calendar day as a DateUtils day number, now or at a given time
+    int localToday() const;
+    int localDay(std::time_t at) const;
+};
+
+#endif // SCHEDULER_H
@@ -0,0 +1,61 @@
+#ifndef SEARCHCACHE_H
+#define SEARCHCACHE_H
+
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include <shared_mutex>
+#include <cstdint>
+#include "utils/EventBus.h"
+
+// Serialized /api/search responses keyed by "from|to|date". Entries are
+// dropped by an EventBus consumer whenever seats on the route and date are
+// reserved or released, so a hit is never staler than the event lag.
+class SearchCache {
+private:
+    static const size_t SHARD_COUNT = 32;
+    
+    struct alignas(64) Shard {
+        std::shared_mutex mutex;
+        std::unordered_map<std::string, std::string> responses;
+        uint64_t epoch; // Bumped on every invalidation in the shard
+    };
+    
+    Shard shards[SHARD_COUNT];
+    std::unordered_map<std::string, std::vector<std::string>> routesByTrain; // Every stop pair
+    size_t maxEntriesPerShard;
+    
+    // Singleton
+    SearchCache();
+    
+    Shard& shardFor(const std::string& key);
+    void apply(const BookingEvent& event);
+    void clear();
+
+public:
+    static SearchCache* getInstance();
+    
+    static std::string makeKey(const std::string& from, const std::string& to,
+                               const std::string& journeyDate);
+    
+    // Indexes the loaded trains and subscribes to the event bus; call once
+    // at startup
+    void start();
+    
+    // Grows the tables ahead of a burst of new keys
+    void reserve(size_t additionalEntries);
+    
+    bool lookup(const std::string& key, std::string& responseJson);
+    
+    // Take the epoch before building a response and pass it to store; a
+    // response built across an invalidation is discarded
+    uint64_t getEpoch(const std::string& key);
+    bool store(const std::string& key, const std::string& responseJson, uint64_t epoch);
+    
+    // Removes entries for journey dates before the given one
+    size_t dropBefore(const std::string& journeyDate);
+    
+    size_t size();
+};
+
+#endif // SEARCHCACHE_H
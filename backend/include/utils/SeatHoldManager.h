@@ -0,0 +1,76 @@
+#ifndef SEATHOLDMANAGER_H
+#define SEATHOLDMANAGER_H
+
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include <mutex>
+#include <thread>
+#include <condition_variable>
+#include <ctime>
+#include "models/Train.h"
+#include "utils/SeatInventory.h"
+#include "utils/TimerWheel.h"
+
+struct SeatHold {
+    uint64_t serial;
+    std::string userId;
+    std::string trainNumber;
+    std::string journeyDate;
+    std::string classCode;
+    Quota quota;
+    int seats;
+    InventoryCounter* counter;
+    std::time_t expiresAt;
+    
+    std::string getHoldId() const;
+    nlohmann::json toJson() const;
+};
+
+// Temporary seat reservations awaiting payment. Seats are taken from the
+// inventory when the hold is placed; confirming hands them to a booking,
+// releasing or expiring returns them. Expiry runs off a timer wheel ticked
+// once per second by a background thread.
+class SeatHoldManager {
+private:
+    std::unordered_map<uint64_t, SeatHold> holds;
+    TimerWheel expiryWheel;
+    uint64_t nextSerial;
+    std::mutex holdMutex;
+    
+    std::thread expiryThread;
+    std::condition_variable expiryCv;
+    bool stopping;
+    
+    // Singleton
+    SeatHoldManager();
+    ~SeatHoldManager();
+    
+    void runExpiryLoop();
+    void expireDue(std::time_t now);
+    static bool parseHoldId(const std::string& holdId, uint64_t& serial);
+
+public:
+    static const int DEFAULT_TTL_SECONDS = 600;
+    static const int MAX_TTL_SECONDS = 900;
+    
+    static SeatHoldManager* getInstance();
+    
+    // Reserves seats and returns the hold, or false if seats ran out
+    bool placeHold(const std::string& userId, const Train& train,
+                   const std::string& journeyDate, const std::string& classCode,
+                   Quota quota, int seats, int ttlSeconds, SeatHold& hold);
+    
+    // Consumes a live hold that matches the booking; the seats stay reserved
+    // and the counter they came from is returned to the caller
+    InventoryCounter* confirmHold(const std::string& holdId, const std::string& userId,
+                                  const std::string& trainNumber,
+                                  const std::string& journeyDate,
+                                  const std::string& classCode, Quota quota, int seats);
+    
+    bool releaseHold(const std::string& holdId, const std::string& userId);
+    
+    size_t getActiveHoldCount();
+};
+
+#endif // SEATHOLDMANAGER_H
@@ -0,0 +1,91 @@
+#ifndef SEATINVENTORY_H
+#define SEATINVENTORY_H
+
+#include <string>
+#include <unordered_map>
+#include <memory>
+#include <atomic>
+#include <shared_mutex>
+#include "models/Train.h"
+
+// Reservation quotas. Each has its own pool inside a class; unsold seats in
+// the special quotas spill over to General.
+enum class Quota {
+    General,    // GN
+    Tatkal,     // TQ
+    Ladies,     // LD
+    Senior,     // SS
+    Count
+};
+
+const int QUOTA_COUNT = static_cast<int>(Quota::Count);
+
+bool parseQuota(const std::string& code, Quota& quota);
+std::string quotaCode(Quota quota);
+
+// Seat counters for one (train, journey date, class), one per quota. All of
+// them share a single cache line so hot trains do not false-share with their
+// neighbours, and a quota reservation touches only its own counter.
+struct alignas(64) InventoryCounter {
+    std::atomic<int> quotaSeats[QUOTA_COUNT];
+    int totalSeats;
+    int initialWaitlist;
+    
+    InventoryCounter(const int (&seeds)[QUOTA_COUNT], int totalSeats, int initialWaitlist = 0);
+    
+    std::atomic<int>& general() { return quotaSeats[static_cast<int>(Quota::General)]; }
+};
+
+class SeatInventory {
+private:
+    static const size_t SHARD_COUNT = 16;
+    
+    struct Shard {
+        std::shared_mutex mutex;
+        std::unordered_map<std::string, std::unique_ptr<InventoryCounter>> counters;
+    };
+    
+    Shard shards[SHARD_COUNT];
+    
+    // Singleton
+    SeatInventory();
+    
+    static std::string makeKey(const std::string& trainNumber,
+                               const std::string& journeyDate,
+                               const std::string& classCode);
+    Shard& shardFor(const std::string& key);
+    static void splitIntoQuotas(const std::string& classCode, int available, 
+                                int (&seeds)[QUOTA_COUNT]);
+
+public:
+    static SeatInventory* getInstance();
+    
+    // Counter for (train, date, class), created from the train's stored
+    // availability on first use. Returns nullptr if the class does not exist.
+    InventoryCounter* getCounter(const Train& train,
+                                 const std::string& journeyDate,
+                                 const std::string& classCode);
+    
+    // Grows the counter tables ahead of a burst of new (train, date, class) keys
+    void reserve(size_t additionalCounters);
+    
+    // Check-and-reserve in one compare-and-swap loop; never oversells
+    static bool tryReserve(InventoryCounter* counter, int seats, Quota quota = Quota::General);
+    static void release(InventoryCounter* counter, int seats, Quota quota = Quota::General);
+    
+    // Empties every special quota and returns the seats taken, so the caller
+    // can hand them to General in one batch
+    static int drainSpecialQuotas(InventoryCounter* counter);
+    
+    bool tryReserve(const Train& train, const std::string& journeyDate,
+                    const std::string& classCode, int seats);
+    bool release(const Train& train, const std::string& journeyDate,
+                 const std::string& classCode, int seats);
+    
+    // Current availability without creating a counter; falls back to the
+    // train's stored availability for dates nobody has booked yet
+    int getAvailableSeats(const Train& train, const std::string& journeyDate,
+                          const std::string& classCode, Quota quota = Quota::General);
+};
+
+#endif // SEATINVENTORY_H
@@ -0,0 +1,180 @@
+#ifndef SEATMAP_H
+#define SEATMAP_H
+
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <memory>
+#include <atomic>
+#include <shared_mutex>
+#include <cstdint>
+#include "models/Train.h"
+#include "utils/CoachLayout.h"
+
+struct SeatRef {
+    int coach; // 1-based
+    int seat;  // 1-based
+};
+
+// Occupancy of one class on one journey date, one bit per seat. Each coach
+// holds up to 128 seats in two words; a set bit is a taken seat. Claiming
+// seats is a compare-and-swap on a word, releasing one is a single atomic
+// bit clear, so bookings never lock the map. Per berth type, a fixed mask
+// picks that type's seats out of a word, and a summary word has a bit per
+// coach that may still have such a berth free, and likewise per party
+// size for a bay, or two adjacent bays, with that many seats free.
+//
+// On trains with intermediate stops each seat also has a mask with a bit
+// per leg. A seat sold for part of the route has its occupancy bit set and
+// a non-zero leg mask; a set bit with an empty mask is a seat sold end to
+// end. Another part-route passenger can take the seat on legs its mask
+// leaves clear.
+class SeatMap {
+public:
+    static const int MAX_SEATS_PER_COACH = 128;
+    static const int MAX_LEGS = 64;
+    static const int MAX_GROUP_SIZE = 6;
+    static const int MAX_BAYS = 32;
+
+private:
+    struct alignas(16) CoachBits {
+        std::atomic<uint64_t> words[2];
+    };
+    
+    int coachCount;
+    CoachLayout layout;
+    uint64_t seatMask[2]; // Bits for seat numbers that exist in a coach
+    uint64_t berthMask[BERTH_TYPE_COUNT][2];
+    std::unique_ptr<CoachBits[]> coaches;
+    std::atomic<int> firstOpenCoach; // No free seat in any coach before this
+    
+    // Bit c of word c / 64 is set while coach c may have a free berth of
+    // the type; cleared lazily by the searches that find it full
+    int summaryWords;
+    std::unique_ptr<std::atomic<uint64_t>[]> berthSummary;
+    
+    // Bay masks, and per party size of 2 and up the coaches that may still
+    // seat it in one bay (bayFit) or in two adjacent bays (pairFit)
+    int bayCount;
+    uint64_t bayMask[MAX_BAYS][2];
+    std::unique_ptr<std::atomic<uint64_t>[]> bayFitSummary;
+    std::unique_ptr<std::atomic<uint64_t>[]> pairFitSummary;
+    
+    int legCount;
+    std::unique_ptr<std::atomic<uint64_t>[]> legMasks; // Per seat, coach-major; null for one leg
+    
+    int claimFromWord(std::atomic<uint64_t>& word, int wordIndex, int coach,
+                      int count, std::vector<SeatRef>& seats);
+    bool claimInMask(int coach, const uint64_t mask[2], SeatRef& seat);
+    bool claimBerth(int coach, BerthType type, SeatRef& seat);
+    std::atomic<uint64_t>& summaryFor(BerthType type, int coach);
+    bool hasFreeBerth(int coach, BerthType type) const;
+    int freeInBay(uint64_t free0, uint64_t free1, int bay) const;
+    int findBays(int coach, int span, int count) const;
+    int baySpan(const std::vector<SeatRef>& seats) const;
+    bool claimBays(int coach, int firstBay, int span, int count, std::vector<SeatRef>& seats);
+    bool allocateInBays(int span, int count, std::vector<SeatRef>& seats);
+    uint64_t partialSeats(int coach, int word, uint64_t legs) const;
+    uint64_t legRange(int fromStop, int toStop) const;
+
+public:
+    SeatMap(int coachCount, const CoachLayout& layout, int legCount = 1);
+    
+    // Claims count seats, lowest free first and kept together where the
+    // coach allows. Either all are claimed or none.
+    bool allocate(int count, std::vector<SeatRef>& seats);
+    
+    // One seat of the preferred berth type, else the nearest type in a fixed
+    // fallback order. False when none of those is free anywhere.
+    bool allocatePreferred(BerthType preferred, SeatRef& seat);
+    
+    // Seats a party in one bay if any bay has room, else in two adjacent
+    // bays, else wherever allocate finds seats. All or nothing.
+    bool allocateGroup(int count, std::vector<SeatRef>& seats);
+    
+    // Seats for the legs from fromStop to toStop, preferring seats already
+    // sold on other legs. freshSeats is how many were free end to end and
+    // so now reduce the seats left for the whole route. All or nothing.
+    bool allocateSegment(int fromStop, int toStop, int count,
+                         std::vector<SeatRef>& seats, int& freshSeats);
+    
+    // Frees a seat's legs; true when that leaves it free end to end
+    bool releaseSegment(const SeatRef& seat, int fromStop, int toStop);
+    
+    // Compaction of seats already sold. New seats are claimed while the
+    // old ones stay taken; the caller releases whichever side it drops.
+    
+    // Seats a party in fewer bays than it now spans, keeping the seats
+    // already inside the chosen bays. targets[i] is seats[i] or its new
+    // seat. False when no tighter placement is free.
+    bool claimRegroup(const std::vector<SeatRef>& seats, std::vector<SeatRef>& targets);
+    
+    // A seat of the same berth type in the fullest other bay with room, if
+    // that bay is at least as full as the seat's own. Moving there drains
+    // sparse bays until whole ones come free.
+    bool claimCompaction(const SeatRef& seat, SeatRef& target);
+    
+    // Marks a seat taken while the map is seeded; false if already taken
+    bool occupy(const SeatRef& seat);
+    void release(const SeatRef& seat);
+    
+    int getCoachCount() const;
+    int getSeatsPerCoach() const;
+    int getLegCount() const;
+    const CoachLayout& getLayout() const;
+    int countFreeSeats() const;
+    
+    // Writes (seatsPerCoach + 7) / 8 bytes for a 0-based coach, seat 1 in
+    // the low bit of the first byte, a set bit taken for the legs from
+    // fromStop to toStop. Relaxed loads: a view, not a reservation.
+    void snapshotCoach(int coach, int fromStop, int toStop, uint8_t* bytes) const;
+};
+
+// Seat maps per (train, journey date, class), created on first use with
+// the seats already sold when the train was loaded marked as taken
+class SeatMapRegistry {
+private:
+    static const size_t SHARD_COUNT = 16;
+    
+    struct Shard {
+        std::shared_mutex mutex;
+        std::unordered_map<std::string, std::unique_ptr<SeatMap>> maps;
+    };
+    
+    Shard shards[SHARD_COUNT];
+    
+    // Singleton
+    SeatMapRegistry();
+    
+    Shard& shardFor(const std::string& key);
+    static std::string mapKey(const Train& train, const std::string& journeyDate,
+                              const std::string& classCode);
+    static void seedOccupancy(SeatMap& map, int totalSeats, int availableSeats, size_t seed);
+    static std::unique_ptr<SeatMap> buildMap(const Train& train, const std::string& key,
+                                             const std::string& classCode);
+
+public:
+    static SeatMapRegistry* getInstance();
+    
+    // Sleeper layout for unknown class codes
+    static const CoachLayout& layoutFor(const std::string& classCode);
+    
+    // Returns nullptr if the train has no such class
+    SeatMap* getMap(const Train& train, const std::string& journeyDate,
+                    const std::string& classCode);
+    
+    // The map if one has been created; never creates one
+    SeatMap* findMap(const Train& train, const std::string& journeyDate,
+                     const std::string& classCode);
+    
+    // A map seeded as getMap would first create it, owned by the caller and
+    // not kept, for reads of dates nothing has been booked on yet. Returns
+    // nullptr if the train has no such class.
+    static std::unique_ptr<SeatMap> previewMap(const Train& train, const std::string& journeyDate,
+                                               const std::string& classCode);
+    
+    // Grows the tables ahead of a burst of new (train, date, class) keys
+    void reserve(size_t additionalMaps);
+};
+
+#endif // SEATMAP_H
@@ -0,0 +1,69 @@
+#ifndef SEATREBALANCER_H
+#define SEATREBALANCER_H
+
+#include <string>
+#include <vector>
+#include <deque>
+#include <unordered_map>
+#include <unordered_set>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <condition_variable>
+#include <atomic>
+#include <cstdint>
+#include "utils/EventBus.h"
+
+// Background compaction of seat maps. Cancellations leave free seats
+// scattered, so parties get split across bays although the class has room.
+// An EventBus consumer notes which (train, date, class) maps lost seats and
+// which bookings hold seats there; a worker thread walks those bookings in
+// short time slices and hands each to the move handler. Seat maps are
+// lock-free and a move takes the booking lock once, so bookings never wait
+// on the rebalancer for longer than a single update. Dates up to the last
+// charted one are left alone.
+class SeatRebalancer {
+public:
+    // Improves one booking's seats; true when it moved any
+    using MoveHandler = std::function<bool(const std::string& bookingId)>;
+
+private:
+    std::mutex mutex;
+    std::condition_variable wake;
+    std::unordered_map<std::string, std::unordered_set<std::string>> bookingsByMap; // "train|date|class"
+    std::deque<std::string> dirtyMaps;
+    std::unordered_set<std::string> dirtySet;
+    std::string chartedThrough; // YYYY-MM-DD; moves only after this date
+    MoveHandler moveHandler;
+    
+    std::thread worker;
+    bool stopping;
+    int sliceMicros;
+    int pauseMillis;
+    std::atomic<uint64_t> moves;
+    
+    // Singleton
+    SeatRebalancer();
+    ~SeatRebalancer();
+    
+    void apply(const BookingEvent& event);
+    void rebuild(bool revisitAll);
+    void markDirty(const std::string& mapKey);
+    void run();
+
+public:
+    static SeatRebalancer* getInstance();
+    
+    void setMoveHandler(MoveHandler handler);
+    
+    // Subscribes to the event bus and starts the worker when
+    // rebalancer.enabled is set; call once at startup
+    void start(const std::string& chartedThrough);
+    
+    // Charts for the date are out; its seats no longer move
+    void closeThrough(const std::string& journeyDate);
+    
+    uint64_t getMoveCount() const;
+};
+
+#endif // SEATREBALANCER_H
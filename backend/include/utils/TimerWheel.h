@@ -0,0 +1,43 @@
+#ifndef TIMERWHEEL_H
+#define TIMERWHEEL_H
+
+#include <cstdint>
+#include <cstddef>
+#include <vector>
+
+// Hierarchical timer wheel: four levels of 64 slots each cover 2^24 ticks.
+// Scheduling is O(1) and advancing only touches due slots plus an occasional
+// cascade, so expiry never scans live timers. Timers are not cancelled;
+// owners ignore ids that are no longer live when they fire.
+class TimerWheel {
+private:
+    static const int LEVELS = 4;
+    static const int SLOT_BITS = 6;
+    static const uint64_t SLOTS = 1ULL << SLOT_BITS;
+    static const uint64_t SLOT_MASK = SLOTS - 1;
+    
+    struct Entry {
+        uint64_t id;
+        uint64_t expiryTick;
+    };
+    
+    std::vector<Entry> slots[LEVELS][SLOTS];
+    uint64_t currentTick;
+    size_t pending;
+    
+    void place(const Entry& entry);
+    void cascade(int level);
+
+public:
+    explicit TimerWheel(uint64_t startTick = 0);
+    
+    void schedule(uint64_t id, uint64_t expiryTick);
+    
+    // Moves the wheel to nowTick and appends the ids that expired
+    void advance(uint64_t nowTick, std::vector<uint64_t>& expired);
+    
+    uint64_t getCurrentTick() const;
+    size_t size() const;
+};
+
+#endif // TIMERWHEEL_H
@@ -0,0 +1,54 @@
+#ifndef TOKENSIGNER_H
+#define TOKENSIGNER_H
+
+#include <string>
+#include <memory>
+#include <atomic>
+#include <ctime>
+#include <cstdint>
+#include "utils/Crypto.h"
+
+// Stateless bearer tokens for security.statelessTokens mode:
+// "st.<userId>.<expiresAt>.<HMAC-SHA256 of userId.expiresAt>" keyed with
+// security.jwtSecret. Verifying one is a MAC and a clock check with no
+// shared state. Logged-out tokens go into a fixed open-addressing table
+// of 64-bit slots (32-bit fingerprint, 32-bit expiry) that is only probed
+// once a token has passed both checks; a slot is reused once its token
+// has expired, so the table never needs cleaning.
+class TokenSigner {
+private:
+    static const int MAX_PROBES = 16;
+    
+    bool enabled;
+    std::unique_ptr<Crypto::HmacSha256> hmac;
+    int ttlSeconds;
+    size_t revokedMask;
+    std::unique_ptr<std::atomic<uint64_t>[]> revoked;
+    
+    // Singleton
+    TokenSigner();
+    
+    std::string sign(const std::string& userId, std::time_t expiresAt) const;
+    bool parse(const std::string& token, std::string& userId,
+               std::time_t& expiresAt, std::string& mac) const;
+    bool isRevoked(const std::string& mac, std::time_t now) const;
+
+public:
+    static TokenSigner* getInstance();
+    
+    bool isEnabled() const;
+    
+    // Tokens of the other mode, or malformed ones, are not ours
+    static bool isSignedToken(const std::string& token);
+    
+    std::string issue(const std::string& userId);
+    
+    // True for a genuine, unexpired, not revoked token
+    bool verify(const std::string& token, std::string& userId) const;
+    
+    // False for invalid tokens, or when the revocation table has no free
+    // slot near the token's
+    bool revoke(const std::string& token);
+};
+
+#endif // TOKENSIGNER_H
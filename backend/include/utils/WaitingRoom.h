@@ -0,0 +1,72 @@
+#ifndef WAITINGROOM_H
+#define WAITINGROOM_H
+
+#include <string>
+#include <atomic>
+#include <mutex>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+
+struct QueueTicket {
+    uint64_t number;
+    std::string token;
+};
+
+// Admission control for booking-window openings. Clients take an ordered,
+// signed ticket and are admitted at a fixed rate; booking requests without
+// an admitted ticket are turned away before any parsing or authentication.
+// An admitted ticket buys one booking and one hold: each guarded route keeps
+// a ring, one slot per ticket in the admission window, holding the number
+// of the ticket that last spent it.
+class WaitingRoom {
+private:
+    bool enabled;
+    double admitRatePerSecond;
+    int admissionWindowSeconds;
+    std::string secret;
+    
+    std::atomic<uint64_t> lastIssued;
+    std::atomic<uint64_t> admittedThrough;
+    
+    std::mutex advanceMutex;
+    double admitCredit;
+    std::chrono::steady_clock::time_point lastAdvance;
+    
+    size_t spentCapacity;
+    std::unique_ptr<std::atomic<uint64_t>[]> spentBookings;
+    std::unique_ptr<std::atomic<uint64_t>[]> spentHolds;
+    
+    // Singleton
+    WaitingRoom();
+    
+    void advance();
+    std::string sign(uint64_t number) const;
+    std::atomic<uint64_t>& spentSlot(const std::string& path, uint64_t number);
+
+public:
+    static WaitingRoom* getInstance();
+    
+    bool isEnabled() const;
+    bool guards(const std::string& method, const std::string& path) const;
+    
+    QueueTicket join();
+    
+    // Verifies the signature; false for forged or malformed tokens
+    bool parseToken(const std::string& token, uint64_t& number) const;
+    
+    // Tickets ahead of this one; 0 once admitted
+    uint64_t getPosition(uint64_t number);
+    
+    // Cheap check for the request path: valid, admitted and not stale
+    bool isAdmitted(const std::string& token, uint64_t& position, uint64_t& number);
+    
+    // Spends an admitted ticket on a guarded route; false if already spent.
+    // restore gives it back after a request that changed nothing.
+    bool spend(const std::string& path, uint64_t number);
+    void restore(const std::string& path, uint64_t number);
+    
+    int estimateWaitSeconds(uint64_t position) const;
+};
+
+#endif // WAITINGROOM_H
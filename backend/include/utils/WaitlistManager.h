@@ -0,0 +1,127 @@
+#ifndef WAITLISTMANAGER_H
+#define WAITLISTMANAGER_H
+
+#include <string>
+#include <deque>
+#include <vector>
+#include <unordered_map>
+#include <memory>
+#include <mutex>
+#include <functional>
+#include "utils/SeatInventory.h"
+
+enum class WaitlistTier {
+    Confirmed,
+    RAC,
+    Waitlisted
+};
+
+struct WaitlistTicket {
+    WaitlistTier tier;
+    int number; // RAC or WL number shown to the passenger
+};
+
+struct WaitlistPromotion {
+    std::string bookingId;
+    std::string trainNumber;
+    std::string journeyDate;
+    std::string classCode;
+    WaitlistTier tier;
+    int number;
+};
+
+// RAC and waitlist queues per (train, journey date, class). Every seat that
+// comes back to a class goes through releaseSeats, which hands it to the
+// queue heads in order before any of it returns to open inventory. Promotions
+// are applied through the registered handler while the queue lock is held;
+// the notify handler runs for each applied promotion once it is released.
+class WaitlistManager {
+public:
+    // Returns false when the promotion cannot be applied; the booking then
+    // stays at the head of its queue and the seats stay banked for it
+    using PromotionHandler = std::function<bool(const WaitlistPromotion&)>;
+    using NotifyHandler = std::function<void(const WaitlistPromotion&)>;
+    
+    static const int MAX_WAITLIST = 100;
+    
+private:
+    static const size_t SHARD_COUNT = 16;
+    
+    struct Entry {
+        std::string bookingId;
+        int seats;
+        int number;
+    };
+    
+    struct Queues {
+        std::mutex mutex;
+        std::deque<Entry> rac;
+        std::deque<Entry> waitlist;
+        InventoryCounter* counter;
+        int racCapacity;
+        int racOccupied;
+        int waitlistOccupied;
+        int bankedSeats; // Freed seats held back for the queue heads
+        int nextRacNumber;
+        int nextWaitlistNumber;
+    };
+    
+    struct Shard {
+        std::mutex mutex;
+        std::unordered_map<std::string, std::unique_ptr<Queues>> queues;
+    };
+    
+    Shard shards[SHARD_COUNT];
+    PromotionHandler promotionHandler;
+    NotifyHandler notifyHandler;
+    
+    // Singleton
+    WaitlistManager();
+    
+    Queues* getQueues(const std::string& trainNumber, const std::string& journeyDate,
+                      const std::string& classCode, InventoryCounter* counter);
+    void promoteLocked(Queues& queues, const std::string& trainNumber,
+                       const std::string& journeyDate, const std::string& classCode,
+                       std::vector<WaitlistPromotion>& applied);
+    void notifyPromoted(const std::vector<WaitlistPromotion>& applied);
+    static int racCapacityFor(const std::string& classCode, int totalSeats);
+
+public:
+    static WaitlistManager* getInstance();
+    
+    void setPromotionHandler(PromotionHandler handler);
+    void setNotifyHandler(NotifyHandler handler);
+    
+    // Creates the queues for a class ahead of demand and grows the tables
+    void reserve(size_t additionalClasses);
+    void prepare(const std::string& trainNumber, const std::string& journeyDate,
+                 const std::string& classCode, InventoryCounter* counter);
+    
+    // For a request that could not reserve seats. Retries the reservation
+    // under the queue lock, otherwise appends to RAC or the waitlist and runs
+    // onQueued inside the critical section so the booking exists before it
+    // can be promoted. Returns false once RAC and the waitlist are full.
+    bool enqueue(const std::string& trainNumber, const std::string& journeyDate,
+                 const std::string& classCode, InventoryCounter* counter,
+                 const std::string& bookingId, int seats, WaitlistTicket& ticket,
+                 const std::function<void(const WaitlistTicket&)>& onQueued);
+    
+    // Returns seats to the class, promoting RAC and waitlisted bookings first.
+    // Special-quota seats go back to their own quota until they spill over.
+    void releaseSeats(const std::string& trainNumber, const std::string& journeyDate,
+                      const std::string& classCode, InventoryCounter* counter, int seats,
+                      Quota quota = Quota::General);
+    
+    // Chart-time spill: every unsold special-quota seat moves to General in
+    // one batch, serving the queues first. Returns the seats moved.
+    int spillQuotas(const std::string& trainNumber, const std::string& journeyDate,
+                    const std::string& classCode, InventoryCounter* counter);
+    
+    // Removes a queued booking and runs onRemoved in the same critical
+    // section. Returns false if the booking is no longer queued.
+    bool cancelQueued(const std::string& trainNumber, const std::string& journeyDate,
+                      const std::string& classCode, InventoryCounter* counter,
+                      const std::string& bookingId, const std::function<void()>& onRemoved);
+};
+
+#endif // WAITLISTMANAGER_H
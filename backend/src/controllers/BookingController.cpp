@@ -1,6 +1,10 @@
 #include "controllers/BookingController.h"
 #include "models/User.h"
 #include "utils/DataStore.h"
+#include "utils/DateUtils.h"
+#include "utils/BookingSequencer.h"
+#include "utils/WaitingRoom.h"
+#include "utils/PnrCache.h"
 #include <iostream>
 
 BookingController::BookingController() {}
@@ -18,6 +22,12 @@ bool BookingController::validateBookingInput(const nlohmann::json& data, std::st
         error = "Journey date is required";
         return false;
     }
+    int journeyDay;
+    if (!data["journeyDate"].is_string() || 
+        !DateUtils::parseDate(data["journeyDate"].get<std::string>(), journeyDay)) {
+        error = "Journey date must be in YYYY-MM-DD format";
+        return false;
+    }
     if (!data.contains("passengers") || !data["passengers"].is_array()) {
         error = "Passengers list is required";
         return false;
@@ -30,6 +40,49 @@ bool BookingController::validateBookingInput(const nlohmann::json& data, std::st
         error = "Maximum 6 passengers allowed";
         return false;
     }
+    Quota quota;
+    if (data.contains("quota") && 
+        (!data["quota"].is_string() || !parseQuota(data["quota"].get<std::string>(), quota))) {
+        error = "Quota must be one of GN, TQ, LD or SS";
+        return false;
+    }
+    return true;
+}
+
+bool BookingController::validateHoldInput(const nlohmann::json& data, std::string& error) {
+    if (!data.contains("train") || !data["train"].contains("trainNumber")) {
+        error = "Train information is required";
+        return false;
+    }
+    if (!data.contains("selectedClass") || !data["selectedClass"].contains("class")) {
+        error = "Class selection is required";
+        return false;
+    }
+    int journeyDay;
+    if (!data.contains("journeyDate") || !data["journeyDate"].is_string() ||
+        !DateUtils::parseDate(data["journeyDate"].get<std::string>(), journeyDay)) {
+        error = "Journey date must be in YYYY-MM-DD format";
+        return false;
+    }
+    if (!data.contains("seats") || !data["seats"].is_number_integer()) {
+        error = "Number of seats is required";
+        return false;
+    }
+    int seats = data["seats"].get<int>();
+    if (seats < 1 || seats > 6) {
+        error = "Seats must be between 1 and 6";
+        return false;
+    }
+    if (data.contains("ttlSeconds") && !data["ttlSeconds"].is_number_integer()) {
+        error = "ttlSeconds must be an integer";
+        return false;
+    }
+    Quota quota;
+    if (data.contains("quota") && 
+        (!data["quota"].is_string() || !parseQuota(data["quota"].get<std::string>(), quota))) {
+        error = "Quota must be one of GN, TQ, LD or SS";
+        return false;
+    }
     return true;
 }
 
@@ -65,16 +118,36 @@ Response BookingController::handleCreateBooking(const Request& request) {
         
         // Parse class and journey date
         std::string classCode = request.body["selectedClass"]["class"].get<std::string>();
-        std::string journeyDate = request.body["journeyDate"].get<std::string>();
+        // Validated above; inventory, seat maps and the ledger are keyed by
+        // the canonical spelling
+        int journeyDay = 0;
+        DateUtils::parseDate(request.body["journeyDate"].get<std::string>(), journeyDay);
+        std::string journeyDate = DateUtils::formatDate(journeyDay);
         std::cout << "Class: " << classCode << ", Date: " << journeyDate << std::endl;
         
         // Parse passengers
         std::vector<Passenger> passengers;
         for (const auto& passengerJson : request.body["passengers"]) {
-            passengers.push_back(Passenger::fromJson(passengerJson));
+            passengers.push_back(Passenger::fromRequestJson(passengerJson));
         }
         std::cout << "Passengers: " << passengers.size() << std::endl;
         
+        // Reservation quota, General unless requested
+        Quota quota = Quota::General;
+        if (request.body.contains("quota")) {
+            parseQuota(request.body["quota"].get<std::string>(), quota);
+        }
+        
+        std::string quotaError;
+        if (!bookingService.checkQuotaEligibility(quota, journeyDate, passengers, quotaError)) {
+            response.setError(quotaError, 400);
+            return response;
+        }
+        
+        // Optional seat hold placed before payment
+        std::string holdId = request.body.contains("holdId") ? 
+                            request.body["holdId"].get<std::string>() : "";
+        
         // Get the stored train to ensure we have updated availability
         DataStore* store = DataStore::getInstance();
         Train* storedTrain = store->findTrainByNumber(train.getTrainNumber());
@@ -87,9 +160,42 @@ Response BookingController::handleCreateBooking(const Request& request) {
         
         std::cout << "Train found in datastore" << std::endl;
         
-        // Create booking
-        Booking* booking = bookingService.createBooking(
-            user, *storedTrain, classCode, journeyDate, passengers
+        // Optional part of the route, terminals by default
+        std::string boardingStation = request.body.contains("boardingStation") ?
+                                      request.body["boardingStation"].get<std::string>() : 
+                                      storedTrain->getFromStation();
+        std::string alightingStation = request.body.contains("alightingStation") ?
+                                       request.body["alightingStation"].get<std::string>() : 
+                                       storedTrain->getToStation();
+        
+        int boardingStop = storedTrain->getStopIndex(boardingStation);
+        int alightingStop = storedTrain->getStopIndex(alightingStation);
+        if (boardingStop < 0 || alightingStop <= boardingStop) {
+            response.setError("Train does not run from " + boardingStation + " to " + alightingStation, 400);
+            return response;
+        }
+        
+        if (boardingStop > 0 || alightingStop < storedTrain->getLegCount()) {
+            if (!holdId.empty()) {
+                response.setError("Seat holds cover the full route only", 400);
+                return response;
+            }
+            if (quota != Quota::General) {
+                response.setError("Quotas apply to full-route bookings only", 400);
+                return response;
+            }
+        }
+        
+        // Create booking on the train's sequencer so requests for one
+        // train are applied one at a time, in arrival order
+        Booking* booking = BookingSequencer::getInstance()->execute<Booking*>(
+            storedTrain->getTrainNumber(),
+            [&]() {
+                return bookingService.createBooking(
+                    user, *storedTrain, classCode, journeyDate, passengers, holdId, quota,
+                    boardingStation, alightingStation
+                );
+            }
         );
         
         if (!booking) {
@@ -100,16 +206,23 @@ Response BookingController::handleCreateBooking(const Request& request) {
         
         std::cout << "Booking created successfully: " << booking->getBookingId() << std::endl;
         
+        std::string message = "Booking confirmed successfully";
+        if (booking->getStatus() == "RAC") {
+            message = "Train is full. Booking placed under RAC";
+        } else if (booking->getStatus() == "Waitlisted") {
+            message = "Train is full. Booking waitlisted";
+        }
+        
         // Return success
         response.statusCode = 201;
         response.body = {
             {"status", "success"},
-            {"message", "Booking confirmed successfully"},
+            {"message", message},
             {"data", booking->toJson(true)}  // Include passengers in response
         };
         
         std::cout << "=== Booking Complete ===" << std::endl;
-        
+    
     } catch (const std::exception& e) {
         std::cerr << "Exception in handleCreateBooking: " << e.what() << std::endl;
         response.setError("Internal server error: " + std::string(e.what()), 500);
@@ -190,7 +303,7 @@ Response BookingController::handleCancelBooking(const Request& request) {
     
     std::string bookingId = request.getPathParam("bookingId");
     
-    // Find booking first to get details for refund calculation
+    // Find booking first to route the cancel to its train
     DataStore* store = DataStore::getInstance();
     Booking* booking = store->findBookingById(bookingId);
     
@@ -199,10 +312,15 @@ Response BookingController::handleCancelBooking(const Request& request) {
         return response;
     }
     
-    double refundAmount = bookingService.calculateRefund(*booking);
+    // Cancel booking on the train's sequencer
+    std::string userId = user->getUserId();
+    double refundAmount = 0.0;
+    bool cancelled = BookingSequencer::getInstance()->execute<bool>(
+        booking->getTrain().getTrainNumber(),
+        [&]() { return bookingService.cancelBooking(bookingId, userId, refundAmount); }
+    );
     
-    // Cancel booking
-    if (!bookingService.cancelBooking(bookingId, user->getUserId())) {
+    if (!cancelled) {
         response.setError("Failed to cancel booking. Already cancelled or not found.", 400);
         return response;
     }
@@ -220,3 +338,250 @@ Response BookingController::handleCancelBooking(const Request& request) {
     
     return response;
 }
+
+Response BookingController::handleCancelPassengers(const Request& request) {
+    Response response;
+    
+    User* user = static_cast<User*>(request.user);
+    if (!user) {
+        response.setError("User not authenticated", 401);
+        return response;
+    }
+    
+    std::string bookingId = request.getPathParam("bookingId");
+    
+    const nlohmann::json& data = request.body;
+    if (!data.contains("passengerIndices") || !data["passengerIndices"].is_array() ||
+        data["passengerIndices"].empty()) {
+        response.setError("passengerIndices must be a non-empty array", 400);
+        return response;
+    }
+    
+    std::vector<int> passengerIndices;
+    for (const auto& index : data["passengerIndices"]) {
+        if (!index.is_number_integer()) {
+            response.setError("passengerIndices must contain integers", 400);
+            return response;
+        }
+        passengerIndices.push_back(index.get<int>());
+    }
+    
+    DataStore* store = DataStore::getInstance();
+    Booking* booking = store->findBookingById(bookingId);
+    if (!booking) {
+        response.setError("Booking not found", 404);
+        return response;
+    }
+    
+    // Same sequencer as full cancellation so releases stay ordered per train
+    std::string userId = user->getUserId();
+    double refundAmount = 0.0;
+    std::string error;
+    bool cancelled = BookingSequencer::getInstance()->execute<bool>(
+        booking->getTrain().getTrainNumber(),
+        [&]() { 
+            return bookingService.cancelPassengers(bookingId, userId, passengerIndices, 
+                                                   refundAmount, error); 
+        }
+    );
+    
+    if (!cancelled) {
+        response.setError(error, error == "Booking not found" ? 404 : 400);
+        return response;
+    }
+    
+    Booking updated = *store->findBookingById(bookingId);
+    
+    response.body = {
+        {"status", "success"},
+        {"message", updated.getStatus() == "Cancelled" 
+            ? "All passengers cancelled, booking cancelled" 
+            : "Passengers cancelled successfully"},
+        {"data", {
+            {"bookingId", bookingId},
+            {"pnr", updated.getPnr()},
+            {"status", updated.getStatus()},
+            {"cancelledPassengers", passengerIndices},
+            {"totalFare", updated.getTotalFare()},
+            {"refundAmount", refundAmount},
+            {"booking", updated.toJson()}
+        }}
+    };
+    
+    return response;
+}
+
+Response BookingController::handleCreateHold(const Request& request) {
+    Response response;
+    
+    User* user = static_cast<User*>(request.user);
+    if (!user) {
+        response.setError("User not authenticated", 401);
+        return response;
+    }
+    
+    std::string error;
+    if (!validateHoldInput(request.body, error)) {
+        response.setError(error, 400);
+        return response;
+    }
+    
+    std::string trainNumber = request.body["train"]["trainNumber"].get<std::string>();
+    std::string classCode = request.body["selectedClass"]["class"].get<std::string>();
+    int journeyDay = 0;
+    DateUtils::parseDate(request.body["journeyDate"].get<std::string>(), journeyDay);
+    std::string journeyDate = DateUtils::formatDate(journeyDay);
+    int seats = request.body["seats"].get<int>();
+    int ttlSeconds = request.body.contains("ttlSeconds") ? 
+                    request.body["ttlSeconds"].get<int>() : SeatHoldManager::DEFAULT_TTL_SECONDS;
+    
+    Quota quota = Quota::General;
+    if (request.body.contains("quota")) {
+        parseQuota(request.body["quota"].get<std::string>(), quota);
+    }
+    
+    // Passengers are checked when the hold is confirmed; only the date matters here
+    if (quota == Quota::Tatkal && 
+        !bookingService.checkQuotaEligibility(quota, journeyDate, {}, error)) {
+        response.setError(error, 400);
+        return response;
+    }
+    
+    DataStore* store = DataStore::getInstance();
+    Train* storedTrain = store->findTrainByNumber(trainNumber);
+    if (!storedTrain) {
+        response.setError("Train not found", 404);
+        return response;
+    }
+    
+    SeatHold hold;
+    bool held = BookingSequencer::getInstance()->execute<bool>(
+        trainNumber,
+        [&]() {
+            return bookingService.holdSeats(user, *storedTrain, classCode, journeyDate, 
+                                            quota, seats, ttlSeconds, hold);
+        }
+    );
+    
+    if (!held) {
+        response.setError("Insufficient seats available to hold", 409);
+        return response;
+    }
+    
+    response.statusCode = 201;
+    response.body = {
+        {"status", "success"},
+        {"message", "Seats held. Confirm with POST /api/bookings before the hold expires."},
+        {"data", hold.toJson()}
+    };
+    
+    return response;
+}
+
+Response BookingController::handleReleaseHold(const Request& request) {
+    Response response;
+    
+    User* user = static_cast<User*>(request.user);
+    if (!user) {
+        response.setError("User not authenticated", 401);
+        return response;
+    }
+    
+    std::string holdId = request.getPathParam("holdId");
+    
+    if (!bookingService.releaseHold(holdId, user->getUserId())) {
+        response.setError("Hold not found, already confirmed or expired", 404);
+        return response;
+    }
+    
+    response.body = {
+        {"status", "success"},
+        {"message", "Seat hold released"},
+        {"data", {{"holdId", holdId}}}
+    };
+    
+    return response;
+}
+
+Response BookingController::handlePnrStatus(const Request& request) {
+    Response response;
+    
+    uint64_t key;
+    if (!PnrCache::encodePnr(request.getPathParam("pnr"), key)) {
+        response.setError("PNR must be 10 digits", 400);
+        return response;
+    }
+    
+    // Served from the cache's pre-serialized projection
+    std::string status;
+    if (!PnrCache::getInstance()->lookup(key, status)) {
+        response.setError("PNR not found", 404);
+        return response;
+    }
+    
+    response.setRaw(status);
+    return response;
+}
+
+Response BookingController::handleJoinQueue(const Request& /*request*/) {
+    Response response;
+    WaitingRoom* room = WaitingRoom::getInstance();
+    
+    if (!room->isEnabled()) {
+        response.body = {
+            {"status", "success"},
+            {"message", "Waiting room is not active, booking is open"},
+            {"data", {{"admitted", true}}}
+        };
+        return response;
+    }
+    
+    QueueTicket ticket = room->join();
+    uint64_t position = room->getPosition(ticket.number);
+    
+    response.statusCode = 201;
+    response.body = {
+        {"status", "success"},
+        {"message", position == 0 ? "Admitted to booking" : "Joined the waiting room"},
+        {"data", {
+            {"ticket", ticket.number},
+            {"token", ticket.token},
+            {"position", position},
+            {"admitted", position == 0},
+            {"estimatedWaitSeconds", room->estimateWaitSeconds(position)}
+        }}
+    };
+    
+    return response;
+}
+
+Response BookingController::handleQueueStatus(const Request& request) {
+    Response response;
+    WaitingRoom* room = WaitingRoom::getInstance();
+    
+    std::string token = request.getPathParam("token");
+    uint64_t number;
+    if (!room->parseToken(token, number)) {
+        response.setError("Invalid queue token", 400);
+        return response;
+    }
+    
+    uint64_t position = 0;
+    bool admitted = room->isAdmitted(token, position, number);
+    if (!admitted && position == 0) {
+        response.setError("Queue token has expired, please rejoin", 410);
+        return response;
+    }
+    
+    response.body = {
+        {"status", "success"},
+        {"data", {
+            {"ticket", number},
+            {"position", position},
+            {"admitted", admitted},
+            {"estimatedWaitSeconds", room->estimateWaitSeconds(position)}
+        }}
+    };
+    
+    return response;
+}
@@ -0,0 +1,66 @@
+#include "controllers/FinanceController.h"
+#include "models/User.h"
+#include "utils/Ledger.h"
+#include "utils/Config.h"
+#include "utils/Crypto.h"
+#include "utils/DateUtils.h"
+
+FinanceController::FinanceController() {}
+
+bool FinanceController::hasFinanceAccess(const Request& request) {
+    // Train and day totals are for operators holding the configured key
+    std::string apiKey = Config::getInstance()->getString("/finance/apiKey", "");
+    std::string provided = request.getHeader("X-Finance-Key");
+    return !apiKey.empty() && Crypto::constantTimeEquals(provided, apiKey);
+}
+
+Response FinanceController::handleSummary(const Request& request) {
+    Response response;
+    
+    User* user = static_cast<User*>(request.user);
+    if (!user) {
+        response.setError("User not authenticated", 401);
+        return response;
+    }
+    
+    std::string trainNumber = request.getQueryParam("train");
+    std::string date = request.getQueryParam("date");
+    
+    int dayNumber;
+    if (!date.empty() && !DateUtils::parseDate(date, dayNumber)) {
+        response.setError("date must be in YYYY-MM-DD format", 400);
+        return response;
+    }
+    
+    Ledger* ledger = Ledger::getInstance();
+    nlohmann::json data;
+    
+    LedgerTotals totals;
+    ledger->getUserTotals(user->getUserId(), totals);
+    data["user"] = totals.toJson();
+    
+    bool operatorQuery = !trainNumber.empty() || !date.empty() || 
+                         !request.getHeader("X-Finance-Key").empty();
+    if (operatorQuery) {
+        if (!hasFinanceAccess(request)) {
+            response.setError("A valid X-Finance-Key is required for train and day totals", 403);
+            return response;
+        }
+        
+        data["overall"] = ledger->getOverallTotals().toJson();
+        
+        if (!trainNumber.empty()) {
+            LedgerTotals trainTotals;
+            ledger->getTrainTotals(trainNumber, trainTotals);
+            data["train"] = {{"trainNumber", trainNumber}, {"totals", trainTotals.toJson()}};
+        }
+        if (!date.empty()) {
+            LedgerTotals dayTotals;
+            ledger->getDayTotals(date, dayTotals);
+            data["day"] = {{"date", date}, {"totals", dayTotals.toJson()}};
+        }
+    }
+    
+    response.setSuccess(data);
+    return response;
+}
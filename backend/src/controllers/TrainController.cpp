@@ -1,5 +1,11 @@
 #include "controllers/TrainController.h"
+#include "services/SearchService.h"
+#include "services/SeatAllocationService.h"
+#include "utils/Config.h"
 #include "utils/DataStore.h"
+#include "utils/DateUtils.h"
+#include "utils/SearchCache.h"
+#include "utils/Scheduler.h"
 #include <iostream>
 #include <sstream>
 
@@ -63,25 +69,208 @@ Response TrainController::handleSearch(const Request& request) {
     
     std::cout << "Searching trains from '" << from << "' to '" << to << "'" << std::endl;
     
-    // Search trains
-    DataStore* store = DataStore::getInstance();
-    std::vector<Train> trains = store->searchTrains(from, to);
+    SearchService searchService;
     
-    // Build response
-    nlohmann::json trainsJson = nlohmann::json::array();
-    for (const auto& train : trains) {
-        trainsJson.push_back(train.toJson());
+    // Dated searches are served from the search cache, filled on first use
+    // and ahead of booking window openings
+    int journeyDay;
+    if (!date.empty() && DateUtils::parseDate(date, journeyDay)) {
+        // Canonical spelling, so one day maps to one cache entry and counter
+        date = DateUtils::formatDate(journeyDay);
+        SearchCache* cache = SearchCache::getInstance();
+        std::string key = SearchCache::makeKey(from, to, date);
+        
+        std::string body;
+        if (!cache->lookup(key, body)) {
+            uint64_t epoch = cache->getEpoch(key);
+            nlohmann::json result = searchService.searchRoute(from, to, date);
+            body = result.dump();
+            
+            // Unknown routes are not cached
+            if (result["count"].get<size_t>() > 0) {
+                cache->store(key, body, epoch);
+            }
+        }
+        
+        response.setRaw(body);
+        return response;
+    }
+    
+    response.body = searchService.searchRoute(from, to, date);
+    return response;
+}
+
+Response TrainController::handleFlexibleSearch(const Request& request) {
+    Response response;
+    
+    std::string from, to, date, error;
+    if (!validateSearchParams(request, from, to, date, error)) {
+        response.setError(error, 400);
+        return response;
+    }
+    
+    std::string startDate = request.getQueryParam("startDate");
+    int startDay;
+    if (startDate.empty()) {
+        startDay = Scheduler::getInstance()->localToday();
+    } else if (!DateUtils::parseDate(startDate, startDay)) {
+        response.setError("Invalid startDate, expected YYYY-MM-DD", 400);
+        return response;
+    }
+    
+    int days = 7;
+    int k = 5;
+    int passengers = 1;
+    try {
+        if (!request.getQueryParam("days").empty()) days = std::stoi(request.getQueryParam("days"));
+        if (!request.getQueryParam("k").empty()) k = std::stoi(request.getQueryParam("k"));
+        if (!request.getQueryParam("passengers").empty()) {
+            passengers = std::stoi(request.getQueryParam("passengers"));
+        }
+    } catch (const std::exception&) {
+        response.setError("days, k and passengers must be integers", 400);
+        return response;
+    }
+    
+    if (days < 1 || days > 31) {
+        response.setError("days must be between 1 and 31", 400);
+        return response;
+    }
+    if (k < 1 || k > 50) {
+        response.setError("k must be between 1 and 50", 400);
+        return response;
+    }
+    if (passengers < 1 || passengers > 6) {
+        response.setError("passengers must be between 1 and 6", 400);
+        return response;
+    }
+    
+    std::string sortBy = request.getQueryParam("sortBy");
+    if (sortBy.empty()) sortBy = "price";
+    if (sortBy != "price" && sortBy != "duration") {
+        response.setError("sortBy must be 'price' or 'duration'", 400);
+        return response;
+    }
+    RankBy rankBy = sortBy == "price" ? RankBy::Price : RankBy::Duration;
+    
+    std::string classCode = request.getQueryParam("class");
+    
+    SearchService searchService;
+    std::vector<RankedTrain> ranked = searchService.findTopTrains(
+        from, to, startDay, days, k, rankBy, classCode, passengers
+    );
+    
+    // Serialize only the K winners
+    nlohmann::json resultsJson = nlohmann::json::array();
+    for (const auto& result : ranked) {
+        const Train& train = *result.train;
+        TrainAvailability avail = train.getAvailabilityRef()[result.classSlot];
+        avail.availableSeats = result.availableSeats;
+        avail.price = result.price;
+        
+        nlohmann::json trainJson = {
+            {"trainNumber", train.getTrainNumber()},
+            {"trainName", train.getTrainName()},
+            {"from", from},
+            {"to", to},
+            {"boardingStation", from},
+            {"alightingStation", to},
+            {"journeyDate", DateUtils::formatDate(result.journeyDay)},
+            {"class", avail.toJson()}
+        };
+        
+        // Times are only known for the full route
+        if (train.getFromStation() == from && train.getToStation() == to) {
+            trainJson["departureTime"] = train.getDepartureTime();
+            trainJson["arrivalTime"] = train.getArrivalTime();
+            trainJson["duration"] = train.getDuration();
+            trainJson["durationMinutes"] = result.durationMinutes;
+        }
+        
+        resultsJson.push_back(trainJson);
     }
     
     response.body = {
         {"status", "success"},
-        {"count", trains.size()},
-        {"trains", trainsJson}
+        {"sortBy", sortBy},
+        {"startDate", DateUtils::formatDate(startDay)},
+        {"days", days},
+        {"count", ranked.size()},
+        {"trains", resultsJson}
     };
     
-    if (trains.empty()) {
-        response.body["message"] = "No trains available for this route";
+    if (ranked.empty()) {
+        response.body["message"] = "No trains available for this route in the selected dates";
+    }
+    
+    return response;
+}
+
+Response TrainController::handleSeatMap(const Request& request) {
+    Response response;
+    
+    std::string trainNumber = request.getPathParam("trainNumber");
+    std::string date = request.getQueryParam("date");
+    std::string classCode = request.getQueryParam("class");
+    
+    int journeyDay;
+    if (date.empty() || !DateUtils::parseDate(date, journeyDay)) {
+        response.setError("Missing or invalid date, expected YYYY-MM-DD", 400);
+        return response;
+    }
+    int today = Scheduler::getInstance()->localToday();
+    int advanceDays = Config::getInstance()->getInt("/scheduler/advanceReservationDays", 60);
+    if (journeyDay < today) {
+        response.setError("date must not be in the past", 400);
+        return response;
+    }
+    if (journeyDay > today + advanceDays) {
+        response.setError("date must be within " + std::to_string(advanceDays) +
+                          " days, when reservations open", 400);
+        return response;
+    }
+    if (classCode.empty()) {
+        response.setError("Missing required parameter: class", 400);
+        return response;
+    }
+    
+    Train* train = DataStore::getInstance()->findTrainByNumber(trainNumber);
+    if (!train) {
+        response.setError("Train not found", 404);
+        return response;
+    }
+    
+    // The whole route unless the traveller's stops are given
+    std::string from = urlDecode(request.getQueryParam("from"));
+    std::string to = urlDecode(request.getQueryParam("to"));
+    int fromStop = from.empty() ? 0 : train->getStopIndex(from);
+    int toStop = to.empty() ? train->getLegCount() : train->getStopIndex(to);
+    if (fromStop < 0 || toStop < 0 || fromStop >= toStop) {
+        response.setError("from and to must be stops of this train, in travel order", 400);
+        return response;
+    }
+    
+    std::string journeyDate = DateUtils::formatDate(journeyDay);
+    SeatAllocationService seatService;
+    nlohmann::json seatMap = seatService.describeSeatMap(*train, journeyDate, classCode,
+                                                         fromStop, toStop);
+    if (seatMap.is_null()) {
+        response.setError("Class " + classCode + " is not available on this train", 404);
+        return response;
     }
     
+    std::vector<std::string> stops = train->getStops();
+    seatMap["trainNumber"] = trainNumber;
+    seatMap["journeyDate"] = journeyDate;
+    seatMap["class"] = classCode;
+    seatMap["from"] = stops[fromStop];
+    seatMap["to"] = stops[toStop];
+    seatMap["encoding"] = "base64; bit (n - 1) % 8 of byte (n - 1) / 8 is seat n, set when taken";
+    
+    response.body = {
+        {"status", "success"},
+        {"data", seatMap}
+    };
+    
     return response;
 }
@@ -2,10 +2,23 @@
 #include <csignal>
 #include "utils/HTTPServer.h"
 #include "utils/Router.h"
+#include "utils/Config.h"
 #include "utils/DataStore.h"
+#include "utils/DateUtils.h"
+#include "utils/FareTable.h"
+#include "utils/NotificationOutbox.h"
+#include "utils/PnrCache.h"
+#include "utils/Scheduler.h"
+#include "utils/SearchCache.h"
+#include "utils/SeatRebalancer.h"
+#include "utils/WaitlistManager.h"
+#include "services/BookingService.h"
+#include "services/BookingWindowService.h"
+#include "services/SeatAllocationService.h"
 #include "controllers/AuthController.h"
 #include "controllers/TrainController.h"
 #include "controllers/BookingController.h"
+#include "controllers/FinanceController.h"
 
 HTTPServer* serverPtr = nullptr;
 
@@ -24,14 +37,51 @@ int main() {
     std::cout << "  TrainTrack Backend Server" << std::endl;
     std::cout << "==================================" << std::endl;
     
+    // Load settings before anything reads them
+    Config::getInstance()->load("config.json");
+    
     // Initialize data store
     DataStore* store = DataStore::getInstance();
     store->initializeSampleData();
     
+    // Fare lookups depend on the loaded trains
+    FareTable::getInstance()->build();
+    
+    // Feed PNR status lookups from booking events
+    PnrCache::getInstance()->start();
+    
+    // Dated searches are cached until seats on the route change
+    SearchCache::getInstance()->start();
+    
+    // Booking confirmations and cancellations go out through the outbox
+    Config* config = Config::getInstance();
+    NotificationOutbox* outbox = NotificationOutbox::getInstance();
+    outbox->setSink(std::unique_ptr<NotificationSink>(new FileNotificationSink(
+        config->getString("/notifications/sinkFile", "./data/notifications.jsonl"))));
+    outbox->start();
+    
+    // Apply RAC/waitlist promotions to the stored bookings
+    WaitlistManager::getInstance()->setPromotionHandler(BookingService::applyPromotion);
+    WaitlistManager::getInstance()->setNotifyHandler(BookingService::notifyPromotion);
+    
+    // Optional background compaction of seat maps; tomorrow's chart may
+    // already be out, so only later dates move
+    SeatRebalancer* rebalancer = SeatRebalancer::getInstance();
+    rebalancer->setMoveHandler([](const std::string& bookingId) {
+        SeatAllocationService seatService;
+        return seatService.rebalanceBooking(bookingId);
+    });
+    rebalancer->start(DateUtils::formatDate(Scheduler::getInstance()->localToday() + 1));
+    
+    // Pre-warm ahead of booking window openings and prepare charts
+    BookingWindowService::scheduleJobs(Scheduler::getInstance());
+    Scheduler::getInstance()->start();
+    
     // Create controllers
     AuthController authController;
     TrainController trainController;
     BookingController bookingController;
+    FinanceController financeController;
     
     // Create router
     Router router;
@@ -68,6 +118,16 @@ int main() {
             return trainController.handleSearch(req); 
         });
     
+    router.addRoute("GET", "/api/search/flexible", 
+        [&trainController](const Request& req) { 
+            return trainController.handleFlexibleSearch(req); 
+        });
+    
+    router.addRoute("GET", "/api/trains/:trainNumber/seatmap", 
+        [&trainController](const Request& req) { 
+            return trainController.handleSeatMap(req); 
+        });
+    
     // Booking routes
     router.addRoute("POST", "/api/bookings", 
         [&bookingController](const Request& req) { 
@@ -89,6 +149,44 @@ int main() {
             return bookingController.handleCancelBooking(req); 
         }, true);
     
+    router.addRoute("POST", "/api/bookings/:bookingId/cancel", 
+        [&bookingController](const Request& req) { 
+            return bookingController.handleCancelPassengers(req); 
+        }, true);
+    
+    router.addRoute("GET", "/api/pnr/:pnr", 
+        [&bookingController](const Request& req) { 
+            return bookingController.handlePnrStatus(req); 
+        });
+    
+    // Seat hold routes
+    router.addRoute("POST", "/api/holds", 
+        [&bookingController](const Request& req) { 
+            return bookingController.handleCreateHold(req); 
+        }, true);
+    
+    router.addRoute("DELETE", "/api/holds/:holdId", 
+        [&bookingController](const Request& req) { 
+            return bookingController.handleReleaseHold(req); 
+        }, true);
+    
+    // Finance routes
+    router.addRoute("GET", "/api/finance/summary", 
+        [&financeController](const Request& req) { 
+            return financeController.handleSummary(req); 
+        }, true);
+    
+    // Waiting room routes
+    router.addRoute("POST", "/api/queue/join", 
+        [&bookingController](const Request& req) { 
+            return bookingController.handleJoinQueue(req); 
+        });
+    
+    router.addRoute("GET", "/api/queue/:token", 
+        [&bookingController](const Request& req) { 
+            return bookingController.handleQueueStatus(req); 
+        });
+    
     // Create server
     HTTPServer server(18080, "0.0.0.0");
     server.setRouter(&router);
@@ -110,10 +208,19 @@ int main() {
     std::cout << "  GET    /api/auth/profile" << std::endl;
     std::cout << "  PUT    /api/auth/profile" << std::endl;
     std::cout << "  GET    /api/search" << std::endl;
+    std::cout << "  GET    /api/search/flexible" << std::endl;
+    std::cout << "  GET    /api/trains/:trainNumber/seatmap" << std::endl;
     std::cout << "  POST   /api/bookings" << std::endl;
     std::cout << "  GET    /api/bookings" << std::endl;
     std::cout << "  GET    /api/bookings/:bookingId" << std::endl;
     std::cout << "  DELETE /api/bookings/:bookingId" << std::endl;
+    std::cout << "  POST   /api/bookings/:bookingId/cancel" << std::endl;
+    std::cout << "  GET    /api/pnr/:pnr" << std::endl;
+    std::cout << "  POST   /api/holds" << std::endl;
+    std::cout << "  DELETE /api/holds/:holdId" << std::endl;
+    std::cout << "  GET    /api/finance/summary" << std::endl;
+    std::cout << "  POST   /api/queue/join" << std::endl;
+    std::cout << "  GET    /api/queue/:token" << std::endl;
     std::cout << "\n==================================" << std::endl;
     
     server.start();
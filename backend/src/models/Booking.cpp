@@ -4,11 +4,11 @@
 #include <sstream>
 #include <random>
 
-Booking::Booking() : pricePerPassenger(0.0), totalFare(0.0), status("Confirmed") {}
+Booking::Booking() : quota("GN"), pricePerPassenger(0.0), totalFare(0.0), status("Confirmed") {}
 
 Booking::Booking(const std::string& userId, const Train& train, 
                  const std::string& classCode)
-    : userId(userId), train(train), classCode(classCode), 
+    : userId(userId), train(train), classCode(classCode), quota("GN"),
       pricePerPassenger(0.0), totalFare(0.0), status("Confirmed") {
     
     // Generate timestamp
@@ -23,6 +23,7 @@ std::string Booking::getPnr() const { return pnr; }
 std::string Booking::getUserId() const { return userId; }
 Train Booking::getTrain() const { return train; }
 std::string Booking::getClassCode() const { return classCode; }
+std::string Booking::getQuota() const { return quota; }
 std::string Booking::getStatus() const { return status; }
 std::vector<Passenger> Booking::getPassengers() const { return passengers; }
 double Booking::getTotalFare() const { return totalFare; }
@@ -30,6 +31,34 @@ double Booking::getPricePerPassenger() const { return pricePerPassenger; }
 std::string Booking::getJourneyDate() const { return journeyDate; }
 std::string Booking::getBookingDate() const { return bookingDate; }
 
+std::string Booking::getBoardingStation() const {
+    return boardingStation.empty() ? train.getFromStation() : boardingStation;
+}
+
+std::string Booking::getAlightingStation() const {
+    return alightingStation.empty() ? train.getToStation() : alightingStation;
+}
+
+int Booking::getBoardingStop() const {
+    return boardingStation.empty() ? 0 : train.getStopIndex(boardingStation);
+}
+
+int Booking::getAlightingStop() const {
+    return alightingStation.empty() ? train.getLegCount() : train.getStopIndex(alightingStation);
+}
+
+bool Booking::isPartialJourney() const {
+    return getBoardingStop() != 0 || getAlightingStop() != train.getLegCount();
+}
+
+int Booking::getActivePassengerCount() const {
+    int count = 0;
+    for (const auto& passenger : passengers) {
+        if (!passenger.isCancelled()) count++;
+    }
+    return count;
+}
+
 void Booking::setBookingId(const std::string& id) { bookingId = id; }
 void Booking::setPnr(const std::string& p) { pnr = p; }
 void Booking::addPassenger(const Passenger& passenger) { 
@@ -37,11 +66,29 @@ void Booking::addPassenger(const Passenger& passenger) {
 }
 void Booking::setPassengers(const std::vector<Passenger>& p) { passengers = p; }
 void Booking::setJourneyDate(const std::string& date) { journeyDate = date; }
+
+void Booking::setSegment(const std::string& boarding, const std::string& alighting) {
+    // Terminals are stored empty so full-route bookings stay unchanged
+    boardingStation = boarding == train.getFromStation() ? "" : boarding;
+    alightingStation = alighting == train.getToStation() ? "" : alighting;
+}
 void Booking::setStatus(const std::string& s) { status = s; }
+void Booking::setQuota(const std::string& q) { quota = q; }
 void Booking::setPricePerPassenger(double price) { pricePerPassenger = price; }
 
+double Booking::getFareFor(const Passenger& passenger) const {
+    // Passengers saved before per-passenger pricing pay the booking rate
+    return passenger.getFare() >= 0.0 ? passenger.getFare() : pricePerPassenger;
+}
+
 void Booking::calculateTotalFare() {
-    totalFare = pricePerPassenger * passengers.size();
+    // Cancelled passengers no longer count towards the fare
+    totalFare = 0.0;
+    for (const auto& passenger : passengers) {
+        if (!passenger.isCancelled()) {
+            totalFare += getFareFor(passenger);
+        }
+    }
 }
 
 std::string Booking::generatePnr() {
@@ -96,7 +143,10 @@ nlohmann::json Booking::toJson(bool includePassengers) const {
             {"class", classCode},
             {"price", pricePerPassenger}
         }},
+        {"quota", quota},
         {"journeyDate", journeyDate},
+        {"boardingStation", getBoardingStation()},
+        {"alightingStation", getAlightingStation()},
         {"totalFare", totalFare},
         {"bookingDate", bookingDate},
         {"status", status}
@@ -127,7 +177,12 @@ Booking Booking::fromJson(const nlohmann::json& json) {
         if (sc.contains("price")) booking.pricePerPassenger = sc["price"].get<double>();
     }
     
+    if (json.contains("quota")) booking.quota = json["quota"].get<std::string>();
     if (json.contains("journeyDate")) booking.journeyDate = json["journeyDate"].get<std::string>();
+    if (json.contains("boardingStation") && json.contains("alightingStation")) {
+        booking.setSegment(json["boardingStation"].get<std::string>(),
+                           json["alightingStation"].get<std::string>());
+    }
     if (json.contains("totalFare")) booking.totalFare = json["totalFare"].get<double>();
     if (json.contains("bookingDate")) booking.bookingDate = json["bookingDate"].get<std::string>();
     if (json.contains("status")) booking.status = json["status"].get<std::string>();
@@ -1,10 +1,10 @@
 #include "models/Passenger.h"
 
-Passenger::Passenger() : age(0) {}
+Passenger::Passenger() : age(0), fare(-1.0) {}
 
 Passenger::Passenger(const std::string& name, int age, 
                      const std::string& gender, const std::string& berth)
-    : name(name), age(age), gender(gender), berthPreference(berth) {}
+    : name(name), age(age), gender(gender), berthPreference(berth), fare(-1.0) {}
 
 std::string Passenger::getName() const { return name; }
 int Passenger::getAge() const { return age; }
@@ -12,9 +12,14 @@ std::string Passenger::getGender() const { return gender; }
 std::string Passenger::getBerthPreference() const { return berthPreference; }
 std::string Passenger::getAssignedSeat() const { return assignedSeat; }
 std::string Passenger::getAssignedBerth() const { return assignedBerth; }
+std::string Passenger::getStatus() const { return status; }
+bool Passenger::isCancelled() const { return status == "Cancelled"; }
+double Passenger::getFare() const { return fare; }
 
 void Passenger::setAssignedSeat(const std::string& seat) { assignedSeat = seat; }
 void Passenger::setAssignedBerth(const std::string& berth) { assignedBerth = berth; }
+void Passenger::setStatus(const std::string& s) { status = s; }
+void Passenger::setFare(double f) { fare = f; }
 
 bool Passenger::isValid() const {
     if (name.empty()) return false;
@@ -37,6 +42,12 @@ nlohmann::json Passenger::toJson() const {
     if (!assignedBerth.empty()) {
         j["assignedBerth"] = assignedBerth;
     }
+    if (!status.empty()) {
+        j["status"] = status;
+    }
+    if (fare >= 0.0) {
+        j["fare"] = fare;
+    }
     
     return j;
 }
@@ -50,6 +61,16 @@ Passenger Passenger::fromJson(const nlohmann::json& json) {
     if (json.contains("berth")) passenger.berthPreference = json["berth"].get<std::string>();
     if (json.contains("assignedSeat")) passenger.assignedSeat = json["assignedSeat"].get<std::string>();
     if (json.contains("assignedBerth")) passenger.assignedBerth = json["assignedBerth"].get<std::string>();
+    if (json.contains("status")) passenger.status = json["status"].get<std::string>();
+    if (json.contains("fare") && json["fare"].is_number()) passenger.fare = json["fare"].get<double>();
+    
+    return passenger;
+}
+
+Passenger Passenger::fromRequestJson(const nlohmann::json& json) {
+    Passenger passenger = fromJson(json);
+    passenger.status.clear();
+    passenger.fare = -1.0;
     
     return passenger;
 }
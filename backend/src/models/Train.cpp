@@ -1,5 +1,21 @@
 #include "models/Train.h"
+#include "utils/DateUtils.h"
 #include <sstream>
+#include <cmath>
+
+bool parseTravelClass(const std::string& code, TravelClass& travelClass) {
+    static const char* const codes[TRAVEL_CLASS_COUNT] = {
+        "1A", "2A", "3A", "3E", "SL", "CC", "EC", "2S"
+    };
+    
+    for (int i = 0; i < TRAVEL_CLASS_COUNT; i++) {
+        if (code == codes[i]) {
+            travelClass = static_cast<TravelClass>(i);
+            return true;
+        }
+    }
+    return false;
+}
 
 // TrainAvailability Implementation
 TrainAvailability::TrainAvailability() 
@@ -39,10 +55,10 @@ TrainAvailability TrainAvailability::fromJson(const nlohmann::json& json) {
 }
 
 // Train Implementation
-Train::Train() {}
+Train::Train() : durationMinutes(-1), fareRow(-1) {}
 
 Train::Train(const std::string& number, const std::string& name)
-    : trainNumber(number), trainName(name) {}
+    : trainNumber(number), trainName(name), durationMinutes(-1), fareRow(-1) {}
 
 std::string Train::getTrainNumber() const { return trainNumber; }
 std::string Train::getTrainName() const { return trainName; }
@@ -51,13 +67,45 @@ std::string Train::getToStation() const { return toStation; }
 std::string Train::getDepartureTime() const { return departureTime; }
 std::string Train::getArrivalTime() const { return arrivalTime; }
 std::string Train::getDuration() const { return duration; }
+int Train::getDurationMinutes() const { return durationMinutes; }
+int Train::getFareRow() const { return fareRow; }
 std::vector<TrainAvailability> Train::getAvailability() const { return availability; }
+const std::vector<TrainAvailability>& Train::getAvailabilityRef() const { return availability; }
+
+std::vector<std::string> Train::getStops() const {
+    std::vector<std::string> stops;
+    stops.reserve(viaStations.size() + 2);
+    stops.push_back(fromStation);
+    stops.insert(stops.end(), viaStations.begin(), viaStations.end());
+    stops.push_back(toStation);
+    return stops;
+}
+
+int Train::getStopIndex(const std::string& station) const {
+    if (station == fromStation) return 0;
+    for (size_t i = 0; i < viaStations.size(); i++) {
+        if (viaStations[i] == station) return static_cast<int>(i) + 1;
+    }
+    if (station == toStation) return static_cast<int>(viaStations.size()) + 1;
+    return -1;
+}
+
+int Train::getLegCount() const { return static_cast<int>(viaStations.size()) + 1; }
+
+double Train::getSegmentShare(int fromStop, int toStop) const {
+    return static_cast<double>(toStop - fromStop) / getLegCount();
+}
 
 void Train::setFromStation(const std::string& from) { fromStation = from; }
 void Train::setToStation(const std::string& to) { toStation = to; }
+void Train::setViaStations(const std::vector<std::string>& stations) { viaStations = stations; }
 void Train::setDepartureTime(const std::string& time) { departureTime = time; }
 void Train::setArrivalTime(const std::string& time) { arrivalTime = time; }
-void Train::setDuration(const std::string& dur) { duration = dur; }
+void Train::setDuration(const std::string& dur) { 
+    duration = dur; 
+    durationMinutes = DateUtils::parseDurationMinutes(dur);
+}
+void Train::setFareRow(int row) { fareRow = row; }
 void Train::setAvailability(const std::vector<TrainAvailability>& avail) { 
     availability = avail; 
 }
@@ -108,6 +156,7 @@ nlohmann::json Train::toJson() const {
         {"trainName", trainName},
         {"from", fromStation},
         {"to", toStation},
+        {"stops", getStops()},
         {"departureTime", departureTime},
         {"arrivalTime", arrivalTime},
         {"duration", duration},
@@ -115,6 +164,30 @@ nlohmann::json Train::toJson() const {
     };
 }
 
+nlohmann::json Train::toSegmentJson(int fromStop, int toStop) const {
+    nlohmann::json json = toJson();
+    std::vector<std::string> stops = getStops();
+    json["boardingStation"] = stops[fromStop];
+    json["alightingStation"] = stops[toStop];
+    
+    if (fromStop == 0 && toStop == getLegCount()) {
+        return json;
+    }
+    
+    json["from"] = stops[fromStop];
+    json["to"] = stops[toStop];
+    json.erase("departureTime");
+    json.erase("arrivalTime");
+    json.erase("duration");
+    
+    double share = getSegmentShare(fromStop, toStop);
+    for (auto& avail : json["availability"]) {
+        avail["price"] = std::round(avail["price"].get<double>() * share);
+    }
+    
+    return json;
+}
+
 Train Train::fromJson(const nlohmann::json& json) {
     Train train;
     
@@ -122,9 +195,13 @@ Train Train::fromJson(const nlohmann::json& json) {
     if (json.contains("trainName")) train.trainName = json["trainName"].get<std::string>();
     if (json.contains("from")) train.fromStation = json["from"].get<std::string>();
     if (json.contains("to")) train.toStation = json["to"].get<std::string>();
+    if (json.contains("stops") && json["stops"].size() > 2) {
+        std::vector<std::string> stops = json["stops"].get<std::vector<std::string>>();
+        train.viaStations.assign(stops.begin() + 1, stops.end() - 1);
+    }
     if (json.contains("departureTime")) train.departureTime = json["departureTime"].get<std::string>();
     if (json.contains("arrivalTime")) train.arrivalTime = json["arrivalTime"].get<std::string>();
-    if (json.contains("duration")) train.duration = json["duration"].get<std::string>();
+    if (json.contains("duration")) train.setDuration(json["duration"].get<std::string>());
     
     if (json.contains("availability")) {
         for (const auto& availJson : json["availability"]) {
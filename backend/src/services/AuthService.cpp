@@ -1,5 +1,6 @@
 #include "services/AuthService.h"
 #include "utils/DataStore.h"
+#include "utils/TokenSigner.h"
 #include <random>
 #include <sstream>
 #include <iomanip>
@@ -109,16 +110,23 @@ std::pair<User*, std::string> AuthService::loginUser(const std::string& email,
         return {nullptr, ""};
     }
     
-    // Generate token
-    std::string token = generateToken(*user);
+    // Signed tokens carry their own expiry; session tokens need a session
+    TokenSigner* signer = TokenSigner::getInstance();
+    if (signer->isEnabled()) {
+        return {user, signer->issue(user->getUserId())};
+    }
     
-    // Store session
+    std::string token = generateToken(*user);
     store->addSession(token, user->getUserId());
     
     return {user, token};
 }
 
 bool AuthService::logoutUser(const std::string& token) {
+    if (TokenSigner::isSignedToken(token)) {
+        return TokenSigner::getInstance()->revoke(token);
+    }
+    
     DataStore* store = DataStore::getInstance();
     store->removeSession(token);
     return true;
@@ -127,10 +135,19 @@ bool AuthService::logoutUser(const std::string& token) {
 User* AuthService::validateToken(const std::string& token) {
     DataStore* store = DataStore::getInstance();
     
-    // Get userId from token
-    std::string userId = store->getUserIdFromToken(token);
-    if (userId.empty()) {
-        return nullptr;
+    // Signed tokens are checked without touching the session store; they
+    // stop verifying if stateless mode is switched off
+    std::string userId;
+    if (TokenSigner::isSignedToken(token)) {
+        TokenSigner* signer = TokenSigner::getInstance();
+        if (!signer->isEnabled() || !signer->verify(token, userId)) {
+            return nullptr;
+        }
+    } else {
+        userId = store->getUserIdFromToken(token);
+        if (userId.empty()) {
+            return nullptr;
+        }
     }
     
     // Find user
@@ -1,12 +1,37 @@
 #include "services/BookingService.h"
 #include "services/SeatAllocationService.h"
 #include "utils/DataStore.h"
+#include "utils/SeatInventory.h"
+#include "utils/DateUtils.h"
+#include "utils/FareTable.h"
+#include "utils/EventBus.h"
+#include "utils/Ledger.h"
+#include "utils/NotificationOutbox.h"
+#include "utils/Scheduler.h"
 #include <random>
+#include <cmath>
 #include <sstream>
 #include <iostream>
 
 BookingService::BookingService() {}
 
+namespace {
+
+// Queued passengers carry their RAC/WL number in place of a seat
+void labelQueuedPassengers(std::vector<Passenger>& passengers, WaitlistTier tier, int number) {
+    for (size_t i = 0; i < passengers.size(); i++) {
+        if (tier == WaitlistTier::RAC) {
+            passengers[i].setAssignedSeat("RAC " + std::to_string(number + i));
+            passengers[i].setAssignedBerth("Side Lower (RAC)");
+        } else {
+            passengers[i].setAssignedSeat("WL " + std::to_string(number + i));
+            passengers[i].setAssignedBerth("");
+        }
+    }
+}
+
+}
+
 std::string BookingService::generateBookingId() {
     std::random_device rd;
     std::mt19937 gen(rd());
@@ -37,92 +62,307 @@ bool BookingService::validateBookingRules(const Booking& booking, std::string& e
         }
     }
     
+    Quota quota;
+    if (!parseQuota(booking.getQuota(), quota)) {
+        error = "Unknown quota " + booking.getQuota();
+        return false;
+    }
+    
+    if (booking.getBoardingStop() < 0 || booking.getAlightingStop() <= booking.getBoardingStop()) {
+        error = "Train does not run from " + booking.getBoardingStation() + 
+                " to " + booking.getAlightingStation();
+        return false;
+    }
+    
+    if (booking.isPartialJourney() && quota != Quota::General) {
+        error = "Quotas apply to full-route bookings only";
+        return false;
+    }
+    
+    return checkQuotaEligibility(quota, booking.getJourneyDate(), booking.getPassengers(), error);
+}
+
+bool BookingService::checkQuotaEligibility(Quota quota,
+                                           const std::string& journeyDate,
+                                           const std::vector<Passenger>& passengers,
+                                           std::string& error) {
+    if (quota == Quota::Tatkal) {
+        int journeyDay;
+        if (!DateUtils::parseDate(journeyDate, journeyDay)) {
+            error = "Invalid journey date";
+            return false;
+        }
+        // Counted in the railway's local day, like the booking-window jobs
+        int daysAhead = journeyDay - Scheduler::getInstance()->localToday();
+        if (daysAhead < 0 || daysAhead > 1) {
+            error = "Tatkal booking opens one day before the journey date";
+            return false;
+        }
+    }
+    
+    for (const auto& passenger : passengers) {
+        bool female = passenger.getGender() == "Female";
+        
+        if (quota == Quota::Ladies && !female && passenger.getAge() >= 12) {
+            error = "Ladies quota is for women and children under 12";
+            return false;
+        }
+        if (quota == Quota::Senior && passenger.getAge() < (female ? 58 : 60)) {
+            error = "Senior citizen quota requires men aged 60+ and women aged 58+";
+            return false;
+        }
+    }
+    
     return true;
 }
 
-bool BookingService::updateTrainAvailability(const std::string& trainNumber,
-                                            const std::string& classCode,
-                                            int seatsToDeduct) {
-    DataStore* store = DataStore::getInstance();
-    Train* train = store->findTrainByNumber(trainNumber);
+void BookingService::priceBooking(Booking& booking,
+                                  std::vector<Passenger>& passengers,
+                                  const Train& train,
+                                  Quota quota,
+                                  const InventoryCounter* counter) {
+    FareTable* fares = FareTable::getInstance();
     
-    if (!train) {
-        return false;
+    // Resolve the class once; each passenger is then pure table lookups
+    double adultFare = -1.0;
+    TravelClass travelClass;
+    if (parseTravelClass(booking.getClassCode(), travelClass)) {
+        adultFare = fares->baseFare(train, travelClass, quota);
+    }
+    if (adultFare < 0.0) {
+        adultFare = train.getPrice(booking.getClassCode());
     }
     
-    if (!train->updateAvailability(classCode, seatsToDeduct)) {
-        return false;
+    // Part-route journeys pay for the legs travelled
+    if (booking.isPartialJourney()) {
+        adultFare *= train.getSegmentShare(booking.getBoardingStop(), booking.getAlightingStop());
     }
     
-    return store->updateTrain(*train);
+    int surgeBucket = FareTable::surgeBucket(counter);
+    booking.setPricePerPassenger(std::round(adultFare * fares->surgeMultiplier(surgeBucket)));
+    
+    for (auto& passenger : passengers) {
+        passenger.setFare(fares->passengerFare(adultFare, quota, passenger.getAge(), surgeBucket));
+    }
 }
 
 Booking* BookingService::createBooking(User* user, 
                                       const Train& train,
                                       const std::string& classCode,
                                       const std::string& journeyDate,
-                                      const std::vector<Passenger>& passengers) {
+                                      const std::vector<Passenger>& passengers,
+                                      const std::string& holdId,
+                                      Quota quota,
+                                      const std::string& boardingStation,
+                                      const std::string& alightingStation) {
     if (!user) {
         return nullptr;
     }
     
     DataStore* store = DataStore::getInstance();
-    
-    // Check seat availability
-    int availableSeats = train.getAvailableSeats(classCode);
-    if (availableSeats < (int)passengers.size()) {
-        std::cerr << "Insufficient seats. Available: " << availableSeats 
-                  << ", Requested: " << passengers.size() << std::endl;
-        return nullptr;
-    }
+    SeatInventory* inventory = SeatInventory::getInstance();
     
     // Create booking
     Booking booking(user->getUserId(), train, classCode);
     booking.setBookingId(generateBookingId());
     booking.setPnr(booking.generatePnr());
     booking.setJourneyDate(journeyDate);
+    booking.setQuota(quotaCode(quota));
+    booking.setSegment(boardingStation.empty() ? train.getFromStation() : boardingStation,
+                       alightingStation.empty() ? train.getToStation() : alightingStation);
+    
+    // Add passengers; fares are set once the seats are secured
+    for (const auto& passenger : passengers) {
+        booking.addPassenger(passenger);
+    }
+    
+    // Validate booking before touching inventory
+    std::string error;
+    if (!validateBookingRules(booking, error)) {
+        std::cerr << "Booking validation failed: " << error << std::endl;
+        return nullptr;
+    }
+    
+    if (booking.isPartialJourney()) {
+        if (!holdId.empty()) {
+            std::cerr << "Seat holds cover the full route only" << std::endl;
+            return nullptr;
+        }
+        return createSegmentBooking(booking, train, passengers);
+    }
+    
+    InventoryCounter* counter = nullptr;
+    int seatsRequested = static_cast<int>(passengers.size());
+    
+    if (!holdId.empty()) {
+        // Seats were reserved when the hold was placed
+        counter = SeatHoldManager::getInstance()->confirmHold(
+            holdId, user->getUserId(), train.getTrainNumber(), 
+            journeyDate, classCode, quota, seatsRequested
+        );
+        if (!counter) {
+            std::cerr << "Seat hold " << holdId << " is invalid, expired or does not match" << std::endl;
+            return nullptr;
+        }
+    } else {
+        // Check and reserve seats in a single atomic step
+        counter = inventory->getCounter(train, journeyDate, classCode);
+        if (!counter) {
+            std::cerr << "Class " << classCode << " not available on " 
+                      << train.getTrainNumber() << std::endl;
+            return nullptr;
+        }
+        
+        if (!SeatInventory::tryReserve(counter, seatsRequested, quota)) {
+            // Quota sold out: join the class's common RAC/waitlist instead,
+            // which is served from General seats
+            quota = Quota::General;
+            booking.setQuota(quotaCode(quota));
+            
+            WaitlistTicket ticket;
+            bool saved = true;
+            bool queued = WaitlistManager::getInstance()->enqueue(
+                train.getTrainNumber(), journeyDate, classCode, counter,
+                booking.getBookingId(), seatsRequested, ticket,
+                [&](const WaitlistTicket& queuedTicket) {
+                    std::vector<Passenger> queuedPassengers = passengers;
+                    priceBooking(booking, queuedPassengers, train, quota, counter);
+                    labelQueuedPassengers(queuedPassengers, queuedTicket.tier, queuedTicket.number);
+                    booking.setPassengers(queuedPassengers);
+                    booking.setStatus(queuedTicket.tier == WaitlistTier::RAC ? "RAC" : "Waitlisted");
+                    booking.calculateTotalFare();
+                    saved = store->addBooking(booking);
+                }
+            );
+            
+            if (!queued) {
+                std::cerr << "No seats, RAC or waitlist left for " << train.getTrainNumber() 
+                          << " " << classCode << " on " << journeyDate << std::endl;
+                return nullptr;
+            }
+            if (ticket.tier != WaitlistTier::Confirmed) {
+                if (!saved) {
+                    return nullptr;
+                }
+                Ledger::getInstance()->record(LedgerEntryType::Fare, booking, booking.getTotalFare());
+                return store->findBookingById(booking.getBookingId());
+            }
+        }
+    }
     
-    // Set price and add passengers
-    double price = train.getPrice(classCode);
-    booking.setPricePerPassenger(price);
+    if (holdId.empty()) {
+        EventBus::getInstance()->publish(BookingEvent::forInventory(
+            BookingEventType::SeatsReserved, train.getTrainNumber(), journeyDate, classCode,
+            seatsRequested, counter->general().load(std::memory_order_relaxed)));
+    }
     
     std::vector<Passenger> passengersCopy = passengers;
+    priceBooking(booking, passengersCopy, train, quota, counter);
     
     // Assign seats
     SeatAllocationService seatService;
-    if (!seatService.assignSeats(passengersCopy, classCode, train.getTrainNumber())) {
+    if (!seatService.assignSeats(passengersCopy, train, journeyDate, classCode)) {
         std::cerr << "Failed to assign seats" << std::endl;
+        WaitlistManager::getInstance()->releaseSeats(train.getTrainNumber(), journeyDate, 
+                                                     classCode, counter, seatsRequested, quota);
         return nullptr;
     }
     
-    for (const auto& passenger : passengersCopy) {
-        booking.addPassenger(passenger);
+    booking.setPassengers(passengersCopy);
+    booking.calculateTotalFare();
+    
+    // Save booking
+    if (!store->addBooking(booking)) {
+        std::cerr << "Failed to save booking" << std::endl;
+        seatService.releaseSeats(passengersCopy, train, journeyDate, classCode);
+        WaitlistManager::getInstance()->releaseSeats(train.getTrainNumber(), journeyDate, 
+                                                     classCode, counter, seatsRequested, quota);
+        return nullptr;
     }
     
-    booking.calculateTotalFare();
+    Ledger::getInstance()->record(LedgerEntryType::Fare, booking, booking.getTotalFare());
+    NotificationOutbox::getInstance()->enqueue(NotificationType::BookingConfirmed, booking);
+    return store->findBookingById(booking.getBookingId());
+}
+
+Booking* BookingService::createSegmentBooking(Booking& booking,
+                                             const Train& train,
+                                             const std::vector<Passenger>& passengers) {
+    DataStore* store = DataStore::getInstance();
+    std::string journeyDate = booking.getJourneyDate();
+    std::string classCode = booking.getClassCode();
     
-    // Validate booking
-    std::string error;
-    if (!validateBookingRules(booking, error)) {
-        std::cerr << "Booking validation failed: " << error << std::endl;
+    InventoryCounter* counter = SeatInventory::getInstance()->getCounter(train, journeyDate, classCode);
+    if (!counter) {
+        std::cerr << "Class " << classCode << " not available on " 
+                  << train.getTrainNumber() << std::endl;
         return nullptr;
     }
     
-    // Update train availability
-    if (!updateTrainAvailability(train.getTrainNumber(), classCode, passengers.size())) {
-        std::cerr << "Failed to update train availability" << std::endl;
+    std::vector<Passenger> passengersCopy = passengers;
+    priceBooking(booking, passengersCopy, train, Quota::General, counter);
+    
+    SeatAllocationService seatService;
+    int fromStop = booking.getBoardingStop();
+    int toStop = booking.getAlightingStop();
+    int freshSeats = 0;
+    if (!seatService.assignSegmentSeats(passengersCopy, train, journeyDate, classCode,
+                                        fromStop, toStop, freshSeats)) {
+        std::cerr << "No seats free from " << booking.getBoardingStation() << " to "
+                  << booking.getAlightingStation() << " on " << train.getTrainNumber() << std::endl;
         return nullptr;
     }
     
-    // Save booking
+    // Seats that were free end to end leave the class count like any other
+    // booking's; seats shared with other legs already did
+    if (freshSeats > 0) {
+        if (!SeatInventory::tryReserve(counter, freshSeats, Quota::General)) {
+            seatService.releaseSegmentSeats(passengersCopy, train, journeyDate, classCode, fromStop, toStop);
+            std::cerr << "No seats left in " << classCode << " on " << train.getTrainNumber() << std::endl;
+            return nullptr;
+        }
+        EventBus::getInstance()->publish(BookingEvent::forInventory(
+            BookingEventType::SeatsReserved, train.getTrainNumber(), journeyDate, classCode,
+            freshSeats, counter->general().load(std::memory_order_relaxed)));
+    }
+    
+    booking.setPassengers(passengersCopy);
+    booking.calculateTotalFare();
+    
     if (!store->addBooking(booking)) {
         std::cerr << "Failed to save booking" << std::endl;
+        releaseConfirmedSeats(booking, passengersCopy, counter, Quota::General);
         return nullptr;
     }
     
+    Ledger::getInstance()->record(LedgerEntryType::Fare, booking, booking.getTotalFare());
+    NotificationOutbox::getInstance()->enqueue(NotificationType::BookingConfirmed, booking);
     return store->findBookingById(booking.getBookingId());
 }
 
+void BookingService::releaseConfirmedSeats(const Booking& booking,
+                                           const std::vector<Passenger>& passengers,
+                                           InventoryCounter* counter,
+                                           Quota quota) {
+    Train train = booking.getTrain();
+    std::string journeyDate = booking.getJourneyDate();
+    std::string classCode = booking.getClassCode();
+    
+    SeatAllocationService seatService;
+    int freed = static_cast<int>(passengers.size());
+    if (booking.isPartialJourney()) {
+        freed = seatService.releaseSegmentSeats(passengers, train, journeyDate, classCode,
+                                                booking.getBoardingStop(), booking.getAlightingStop());
+    } else {
+        seatService.releaseSeats(passengers, train, journeyDate, classCode);
+    }
+    
+    if (freed > 0) {
+        WaitlistManager::getInstance()->releaseSeats(train.getTrainNumber(), journeyDate, classCode,
+                                                     counter, freed, quota);
+    }
+}
+
 std::vector<Booking> BookingService::getUserBookings(const std::string& userId,
                                                      const std::string& status) {
     DataStore* store = DataStore::getInstance();
@@ -143,7 +383,8 @@ std::vector<Booking> BookingService::getUserBookings(const std::string& userId,
 }
 
 bool BookingService::cancelBooking(const std::string& bookingId, 
-                                   const std::string& userId) {
+                                   const std::string& userId,
+                                   double& refundAmount) {
     DataStore* store = DataStore::getInstance();
     Booking* booking = store->findBookingById(bookingId);
     
@@ -156,31 +397,204 @@ bool BookingService::cancelBooking(const std::string& bookingId,
         return false;
     }
     
-    // Check if already cancelled
-    if (booking->getStatus() == "Cancelled") {
+    Train train = booking->getTrain();
+    std::string journeyDate = booking->getJourneyDate();
+    std::string classCode = booking->getClassCode();
+    std::string status = booking->getStatus();
+    
+    Quota quota = Quota::General;
+    parseQuota(booking->getQuota(), quota);
+    
+    InventoryCounter* counter = SeatInventory::getInstance()->getCounter(train, journeyDate, classCode);
+    WaitlistManager* waitlist = WaitlistManager::getInstance();
+    
+    if (status == "RAC" || status == "Waitlisted") {
+        // Leave the queue and cancel in one step so it cannot be promoted meanwhile
+        bool removed = waitlist->cancelQueued(
+            train.getTrainNumber(), journeyDate, classCode, counter, bookingId,
+            [&]() {
+                std::string previousStatus;
+                store->transitionBookingStatus(bookingId, "Cancelled", previousStatus);
+            }
+        );
+        if (removed) {
+            refundAmount = calculateRefund(*booking);
+            Ledger::getInstance()->record(LedgerEntryType::Refund, *booking, refundAmount);
+            NotificationOutbox::getInstance()->enqueue(NotificationType::BookingCancelled,
+                                                       *booking, refundAmount);
+            return true;
+        }
+        // Promoted to a confirmed berth just before the cancel
+    }
+    
+    // Flip the status atomically so concurrent cancels release seats once
+    std::string previousStatus;
+    if (!store->transitionBookingStatus(bookingId, "Cancelled", previousStatus)) {
         return false;
     }
     
-    // Update status
-    booking->setStatus("Cancelled");
+    // Freed seats go to RAC and waitlisted bookings before open inventory
+    if (previousStatus == "Confirmed") {
+        std::vector<Passenger> seated;
+        for (const auto& passenger : booking->getPassengers()) {
+            if (!passenger.isCancelled()) seated.push_back(passenger);
+        }
+        releaseConfirmedSeats(*booking, seated, counter, quota);
+    }
+    
+    refundAmount = calculateRefund(*booking);
+    Ledger::getInstance()->record(LedgerEntryType::Refund, *booking, refundAmount);
+    NotificationOutbox::getInstance()->enqueue(NotificationType::BookingCancelled,
+                                               *booking, refundAmount);
+    return true;
+}
+
+bool BookingService::cancelPassengers(const std::string& bookingId,
+                                      const std::string& userId,
+                                      const std::vector<int>& passengerIndices,
+                                      double& refundAmount,
+                                      std::string& error) {
+    DataStore* store = DataStore::getInstance();
+    Booking* booking = store->findBookingById(bookingId);
+    
+    if (!booking || booking->getUserId() != userId) {
+        error = "Booking not found";
+        return false;
+    }
     
-    // Restore train availability
     Train train = booking->getTrain();
-    int passengerCount = booking->getPassengers().size();
-    
-    Train* storedTrain = store->findTrainByNumber(train.getTrainNumber());
-    if (storedTrain) {
-        // Restore seats
-        for (auto& avail : storedTrain->getAvailability()) {
-            if (avail.classCode == booking->getClassCode()) {
-                avail.availableSeats += passengerCount;
-                break;
+    std::string journeyDate = booking->getJourneyDate();
+    std::string classCode = booking->getClassCode();
+    
+    Quota quota = Quota::General;
+    parseQuota(booking->getQuota(), quota);
+    
+    // Validate and apply under the booking lock so concurrent cancels cannot
+    // release the same passenger twice
+    int cancelledCount = 0;
+    double cancelledFare = 0.0;
+    std::vector<Passenger> cancelledPassengers;
+    store->modifyBooking(bookingId, [&](Booking& stored) {
+        if (stored.getStatus() != "Confirmed") {
+            error = stored.getStatus() == "Cancelled" 
+                ? "Booking is already cancelled" 
+                : "RAC and waitlisted bookings can only be cancelled in full";
+            return;
+        }
+        
+        std::vector<Passenger> passengers = stored.getPassengers();
+        std::vector<bool> selected(passengers.size(), false);
+        for (int index : passengerIndices) {
+            if (index < 0 || index >= static_cast<int>(passengers.size())) {
+                error = "Passenger index " + std::to_string(index) + " is out of range";
+                return;
+            }
+            if (selected[index] || passengers[index].isCancelled()) {
+                error = "Passenger " + std::to_string(index) + " is already cancelled";
+                return;
+            }
+            selected[index] = true;
+        }
+        
+        for (size_t i = 0; i < passengers.size(); i++) {
+            if (selected[i]) {
+                passengers[i].setStatus("Cancelled");
+                cancelledPassengers.push_back(passengers[i]);
+                cancelledFare += stored.getFareFor(passengers[i]);
+                cancelledCount++;
+            }
+        }
+        
+        stored.setPassengers(passengers);
+        stored.calculateTotalFare();
+        if (stored.getActivePassengerCount() == 0) {
+            stored.setStatus("Cancelled");
+        }
+    });
+    
+    if (cancelledCount == 0) {
+        if (error.empty()) error = "No passengers selected";
+        return false;
+    }
+    
+    // Freed seats go straight back to their quota or to the RAC/waitlist
+    InventoryCounter* counter = SeatInventory::getInstance()->getCounter(train, journeyDate, classCode);
+    releaseConfirmedSeats(*booking, cancelledPassengers, counter, quota);
+    
+    refundAmount = calculateRefund(cancelledFare);
+    Ledger::getInstance()->record(LedgerEntryType::Refund, *booking, refundAmount);
+    NotificationOutbox::getInstance()->enqueue(
+        booking->getStatus() == "Cancelled" ? NotificationType::BookingCancelled
+                                            : NotificationType::PassengersCancelled,
+        *booking, refundAmount);
+    return true;
+}
+
+bool BookingService::applyPromotion(const WaitlistPromotion& promotion) {
+    DataStore* store = DataStore::getInstance();
+    
+    bool applied = true;
+    store->modifyBooking(promotion.bookingId, [&promotion, &applied](Booking& booking) {
+        std::vector<Passenger> passengers = booking.getPassengers();
+        
+        if (promotion.tier == WaitlistTier::Confirmed) {
+            SeatAllocationService seatService;
+            if (!seatService.assignSeats(passengers, booking.getTrain(), 
+                                         booking.getJourneyDate(), booking.getClassCode())) {
+                // Stays queued with its RAC/WL labels until seats free up
+                applied = false;
+                return;
             }
+            booking.setStatus("Confirmed");
+        } else {
+            labelQueuedPassengers(passengers, promotion.tier, promotion.number);
+            booking.setStatus("RAC");
         }
-        store->updateTrain(*storedTrain);
+        
+        booking.setPassengers(passengers);
+    });
+    
+    if (!applied) {
+        std::cerr << "No free seat in the seat map for promoted booking " 
+                  << promotion.bookingId << ", left queued" << std::endl;
+        return false;
+    }
+    
+    std::cout << "Booking " << promotion.bookingId << " promoted to "
+              << (promotion.tier == WaitlistTier::Confirmed ? "Confirmed" : "RAC") << std::endl;
+    return true;
+}
+
+void BookingService::notifyPromotion(const WaitlistPromotion& promotion) {
+    if (promotion.tier != WaitlistTier::Confirmed) {
+        return;
+    }
+    
+    Booking* booking = DataStore::getInstance()->findBookingById(promotion.bookingId);
+    if (booking) {
+        NotificationOutbox::getInstance()->enqueue(NotificationType::BookingConfirmed, *booking);
+    }
+}
+
+bool BookingService::holdSeats(User* user,
+                               const Train& train,
+                               const std::string& classCode,
+                               const std::string& journeyDate,
+                               Quota quota,
+                               int seats,
+                               int ttlSeconds,
+                               SeatHold& hold) {
+    if (!user || seats < 1 || seats > 6) {
+        return false;
     }
     
-    return store->updateBooking(*booking);
+    return SeatHoldManager::getInstance()->placeHold(
+        user->getUserId(), train, journeyDate, classCode, quota, seats, ttlSeconds, hold
+    );
+}
+
+bool BookingService::releaseHold(const std::string& holdId, const std::string& userId) {
+    return SeatHoldManager::getInstance()->releaseHold(holdId, userId);
 }
 
 double BookingService::calculateRefund(const Booking& booking) {
@@ -188,6 +602,10 @@ double BookingService::calculateRefund(const Booking& booking) {
         return 0.0;
     }
     
+    return calculateRefund(booking.getTotalFare());
+}
+
+double BookingService::calculateRefund(double cancelledFare) {
     // 80% refund policy
-    return booking.getTotalFare() * 0.8;
+    return cancelledFare * 0.8;
 }
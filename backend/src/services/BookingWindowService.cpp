@@ -0,0 +1,122 @@
+#include "services/BookingWindowService.h"
+#include "services/SearchService.h"
+#include "utils/Config.h"
+#include "utils/DataStore.h"
+#include "utils/DateUtils.h"
+#include "utils/SearchCache.h"
+#include "utils/SeatMap.h"
+#include "utils/SeatInventory.h"
+#include "utils/SeatRebalancer.h"
+#include "utils/WaitlistManager.h"
+#include <iostream>
+
+BookingWindowService::BookingWindowService() {}
+
+int BookingWindowService::prewarm(const std::string& journeyDate) {
+    std::vector<Train> trains;
+    DataStore* store = DataStore::getInstance();
+    store->forEachTrain([&trains](Train& train) { trains.push_back(train); });
+    
+    size_t classCount = 0;
+    for (const auto& train : trains) {
+        classCount += train.getAvailabilityRef().size();
+    }
+    
+    // Size the tables once instead of rehashing under the opening burst
+    SeatInventory* inventory = SeatInventory::getInstance();
+    WaitlistManager* waitlist = WaitlistManager::getInstance();
+    SeatMapRegistry* seatMaps = SeatMapRegistry::getInstance();
+    inventory->reserve(classCount);
+    waitlist->reserve(classCount);
+    seatMaps->reserve(classCount);
+    
+    for (const auto& train : trains) {
+        for (const auto& avail : train.getAvailabilityRef()) {
+            InventoryCounter* counter = inventory->getCounter(train, journeyDate, avail.classCode);
+            waitlist->prepare(train.getTrainNumber(), journeyDate, avail.classCode, counter);
+            seatMaps->getMap(train, journeyDate, avail.classCode);
+        }
+    }
+    
+    // Pre-serialize the dated search for every route
+    std::vector<std::pair<std::string, std::string>> routes = store->getRoutes();
+    SearchCache* cache = SearchCache::getInstance();
+    cache->reserve(routes.size());
+    
+    SearchService searchService;
+    size_t cached = 0;
+    for (const auto& route : routes) {
+        std::string key = SearchCache::makeKey(route.first, route.second, journeyDate);
+        uint64_t epoch = cache->getEpoch(key);
+        nlohmann::json result = searchService.searchRoute(route.first, route.second, journeyDate);
+        if (cache->store(key, result.dump(), epoch)) {
+            cached++;
+        }
+    }
+    
+    std::cout << "Pre-warmed " << journeyDate << ": " << classCount << " classes, "
+              << cached << " of " << routes.size() << " routes cached" << std::endl;
+    return static_cast<int>(classCount);
+}
+
+int BookingWindowService::prepareCharts(const std::string& journeyDate) {
+    // Seat numbers on the chart are final
+    SeatRebalancer::getInstance()->closeThrough(journeyDate);
+    
+    std::vector<Train> trains;
+    DataStore::getInstance()->forEachTrain([&trains](Train& train) { trains.push_back(train); });
+    
+    SeatInventory* inventory = SeatInventory::getInstance();
+    WaitlistManager* waitlist = WaitlistManager::getInstance();
+    
+    int spilled = 0;
+    for (const auto& train : trains) {
+        for (const auto& avail : train.getAvailabilityRef()) {
+            InventoryCounter* counter = inventory->getCounter(train, journeyDate, avail.classCode);
+            if (!counter) continue;
+            spilled += waitlist->spillQuotas(train.getTrainNumber(), journeyDate,
+                                             avail.classCode, counter);
+        }
+    }
+    
+    std::cout << "Charts for " << journeyDate << ": " << spilled
+              << " quota seat(s) released to General" << std::endl;
+    return spilled;
+}
+
+void BookingWindowService::scheduleJobs(Scheduler* scheduler) {
+    Config* config = Config::getInstance();
+    int advanceDays = config->getInt("/scheduler/advanceReservationDays", 60);
+    
+    // General booking opens advanceDays ahead; tatkal opens the day before
+    // travel (AC at 10:00, non-AC at 11:00), so one run covers both
+    scheduler->scheduleDaily("advance-prewarm",
+        config->getString("/scheduler/advancePrewarmAt", "07:50"),
+        [scheduler, advanceDays]() {
+            BookingWindowService service;
+            service.prewarm(DateUtils::formatDate(scheduler->localToday() + advanceDays));
+        });
+    
+    scheduler->scheduleDaily("tatkal-prewarm",
+        config->getString("/scheduler/tatkalPrewarmAt", "09:50"),
+        [scheduler]() {
+            BookingWindowService service;
+            service.prewarm(DateUtils::formatDate(scheduler->localToday() + 1));
+        });
+    
+    // Charts for the next day's trains close the special quotas
+    scheduler->scheduleDaily("chart-preparation",
+        config->getString("/scheduler/chartAt", "20:00"),
+        [scheduler]() {
+            BookingWindowService service;
+            service.prepareCharts(DateUtils::formatDate(scheduler->localToday() + 1));
+        });
+    
+    // Departed dates can no longer be searched for availability
+    scheduler->scheduleDaily("search-cache-purge", "00:05",
+        [scheduler]() {
+            size_t dropped = SearchCache::getInstance()->dropBefore(
+                DateUtils::formatDate(scheduler->localToday()));
+            std::cout << "Dropped " << dropped << " cached search(es) for past dates" << std::endl;
+        });
+}
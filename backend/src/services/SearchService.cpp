@@ -0,0 +1,173 @@
+#include "services/SearchService.h"
+#include "utils/DataStore.h"
+#include "utils/DateUtils.h"
+#include "utils/SeatInventory.h"
+#include <queue>
+#include <algorithm>
+
+SearchService::SearchService() {}
+
+namespace {
+
+// Ordering key: primary metric, then earlier departure, then earlier day
+struct Candidate {
+    double key;
+    int departureMinutes;
+    int journeyDay;
+    size_t rowIndex;
+};
+
+struct RanksBefore {
+    bool operator()(const Candidate& a, const Candidate& b) const {
+        if (a.key != b.key) return a.key < b.key;
+        if (a.journeyDay != b.journeyDay) return a.journeyDay < b.journeyDay;
+        return a.departureMinutes < b.departureMinutes;
+    }
+};
+
+}
+
+nlohmann::json SearchService::searchRoute(const std::string& from, const std::string& to,
+                                         const std::string& journeyDate) {
+    std::vector<Train> trains = DataStore::getInstance()->searchTrains(from, to);
+    
+    // Show availability for the requested journey date when one is given
+    int journeyDay;
+    if (!journeyDate.empty() && DateUtils::parseDate(journeyDate, journeyDay)) {
+        SeatInventory* inventory = SeatInventory::getInstance();
+        for (auto& train : trains) {
+            std::vector<TrainAvailability> availability = train.getAvailability();
+            for (auto& avail : availability) {
+                avail.availableSeats = inventory->getAvailableSeats(train, journeyDate, avail.classCode);
+            }
+            train.setAvailability(availability);
+        }
+    }
+    
+    // Through trains are listed for the searched part of their route
+    nlohmann::json trainsJson = nlohmann::json::array();
+    for (const auto& train : trains) {
+        trainsJson.push_back(train.toSegmentJson(train.getStopIndex(from), train.getStopIndex(to)));
+    }
+    
+    nlohmann::json body = {
+        {"status", "success"},
+        {"count", trains.size()},
+        {"trains", trainsJson}
+    };
+    
+    if (trains.empty()) {
+        body["message"] = "No trains available for this route";
+    }
+    
+    return body;
+}
+
+int SearchService::seatsOnDate(const AvailabilityRow& row, const std::string& journeyDate) {
+    const std::string& classCode = row.train->getAvailabilityRef()[row.classSlot].classCode;
+    return SeatInventory::getInstance()->getAvailableSeats(*row.train, journeyDate, classCode);
+}
+
+std::vector<RankedTrain> SearchService::findTopTrains(const std::string& from,
+                                                      const std::string& to,
+                                                      int startDay,
+                                                      int days,
+                                                      size_t k,
+                                                      RankBy rankBy,
+                                                      const std::string& classCode,
+                                                      int seatsRequired) {
+    std::vector<RankedTrain> results;
+    if (k == 0 || days <= 0) {
+        return results;
+    }
+    
+    DataStore* store = DataStore::getInstance();
+    std::vector<AvailabilityRow> rows = store->getRouteAvailabilityRows(from, to);
+    
+    std::vector<std::string> journeyDates;
+    for (int offset = 0; offset < days; offset++) {
+        journeyDates.push_back(DateUtils::formatDate(startDay + offset));
+    }
+    
+    // Rows arrive grouped by train; keep the best bookable (class, day) per train
+    std::vector<Candidate> perTrain;
+    perTrain.reserve(rows.size());
+    
+    const Train* currentTrain = nullptr;
+    bool haveBest = false;
+    Candidate best{};
+    
+    auto flush = [&]() {
+        if (haveBest) perTrain.push_back(best);
+        haveBest = false;
+    };
+    
+    for (size_t i = 0; i < rows.size(); i++) {
+        const AvailabilityRow& row = rows[i];
+        if (row.train != currentTrain) {
+            flush();
+            currentTrain = row.train;
+        }
+        
+        if (!classCode.empty() && 
+            row.train->getAvailabilityRef()[row.classSlot].classCode != classCode) {
+            continue;
+        }
+        if (rankBy == RankBy::Duration && row.durationMinutes < 0) {
+            continue;
+        }
+        
+        for (int offset = 0; offset < days; offset++) {
+            int day = startDay + offset;
+            if (seatsOnDate(row, journeyDates[offset]) < seatsRequired) continue;
+            
+            Candidate candidate;
+            candidate.key = rankBy == RankBy::Price ? row.price : row.durationMinutes;
+            candidate.departureMinutes = row.departureMinutes;
+            candidate.journeyDay = day;
+            candidate.rowIndex = i;
+            
+            // Duration ties across classes are broken by the cheaper fare
+            bool better = !haveBest || RanksBefore()(candidate, best) ||
+                (rankBy == RankBy::Duration && candidate.key == best.key &&
+                 candidate.journeyDay == best.journeyDay && 
+                 row.price < rows[best.rowIndex].price);
+            if (better) {
+                best = candidate;
+                haveBest = true;
+            }
+            break;
+        }
+    }
+    flush();
+    
+    // Bounded heap: the lowest-ranked of the current K winners sits on top
+    std::priority_queue<Candidate, std::vector<Candidate>, RanksBefore> heap;
+    for (const auto& candidate : perTrain) {
+        if (heap.size() < k) {
+            heap.push(candidate);
+        } else if (RanksBefore()(candidate, heap.top())) {
+            heap.pop();
+            heap.push(candidate);
+        }
+    }
+    
+    results.resize(heap.size());
+    for (size_t i = heap.size(); i > 0; i--) {
+        const Candidate& candidate = heap.top();
+        const AvailabilityRow& row = rows[candidate.rowIndex];
+        
+        RankedTrain ranked;
+        ranked.train = row.train;
+        ranked.classSlot = row.classSlot;
+        ranked.journeyDay = candidate.journeyDay;
+        ranked.availableSeats = seatsOnDate(row, journeyDates[candidate.journeyDay - startDay]);
+        ranked.durationMinutes = row.durationMinutes;
+        ranked.price = row.price;
+        results[i - 1] = ranked;
+        
+        heap.pop();
+    }
+    
+    return results;
+}
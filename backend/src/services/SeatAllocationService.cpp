@@ -1,72 +1,267 @@
 #include "services/SeatAllocationService.h"
-#include <random>
+#include "utils/Crypto.h"
+#include "utils/DataStore.h"
 #include <sstream>
 
-SeatAllocationService::SeatAllocationService() : nextSeatNumber(1) {}
+SeatAllocationService::SeatAllocationService() {}
 
-std::string SeatAllocationService::generateCoachPrefix(const std::string& classCode) {
-    if (classCode == "SL") return "S";
-    if (classCode == "3A") return "B";
-    if (classCode == "2A") return "A";
-    if (classCode == "1A") return "H";
-    if (classCode == "CC") return "H";
-    if (classCode == "EC") return "H";
-    return "S";
-}
-
-int SeatAllocationService::getRandomCoachNumber() {
-    std::random_device rd;
-    std::mt19937 gen(rd());
-    std::uniform_int_distribution<> dis(1, 5);
-    return dis(gen);
-}
-
-std::string SeatAllocationService::getBerthType(int seatNumber, const std::string& classCode) {
-    // Berth assignment based on seat number
-    int mod = seatNumber % 8;
-    
-    if (classCode == "SL" || classCode == "3A" || classCode == "2A") {
-        switch (mod) {
-            case 1: return "Lower";
-            case 2: return "Middle";
-            case 3: return "Upper";
-            case 4: return "Lower";
-            case 5: return "Middle";
-            case 6: return "Upper";
-            case 7: return "Side Lower";
-            case 0: return "Side Upper";
-            default: return "Lower";
-        }
-    } else {
-        // For CC, EC, 1A (sitting)
-        return "Seat";
+bool SeatAllocationService::parseSeatLabel(const std::string& label, SeatRef& seat) {
+    // "B3-41": coach prefix letters, coach number, seat number
+    size_t dash = label.find('-');
+    size_t digits = label.find_first_of("0123456789");
+    if (dash == std::string::npos || digits == std::string::npos || digits > dash) {
+        return false;
     }
+    try {
+        seat.coach = std::stoi(label.substr(digits, dash - digits));
+        seat.seat = std::stoi(label.substr(dash + 1));
+    } catch (const std::exception&) {
+        return false;
+    }
+    return true;
 }
 
 bool SeatAllocationService::assignSeats(std::vector<Passenger>& passengers, 
-                                       const std::string& classCode,
-                                       const std::string& trainNumber) {
-    std::string coachPrefix = generateCoachPrefix(classCode);
-    int coachNumber = getRandomCoachNumber();
+                                       const Train& train,
+                                       const std::string& journeyDate,
+                                       const std::string& classCode) {
+    SeatMap* seatMap = SeatMapRegistry::getInstance()->getMap(train, journeyDate, classCode);
+    if (!seatMap) {
+        return false;
+    }
     
-    std::random_device rd;
-    std::mt19937 gen(rd());
-    std::uniform_int_distribution<> dis(1, 72);
+    // Passengers with a berth preference take one seat each from that
+    // berth type's masks; the rest are seated together, in one bay where
+    // one has room
+    std::vector<SeatRef> seats(passengers.size());
+    std::vector<size_t> unplaced;
+    std::vector<SeatRef> claimed;
+    bool allocated = true;
     
-    int startSeat = dis(gen);
+    for (size_t i = 0; i < passengers.size() && allocated; i++) {
+        BerthType preferred;
+        if (!parseBerthType(passengers[i].getBerthPreference(), preferred)) {
+            unplaced.push_back(i);
+        } else if (seatMap->allocatePreferred(preferred, seats[i])) {
+            claimed.push_back(seats[i]);
+        } else {
+            allocated = false;
+        }
+    }
+    
+    if (allocated && !unplaced.empty()) {
+        std::vector<SeatRef> together;
+        if (seatMap->allocateGroup(static_cast<int>(unplaced.size()), together)) {
+            for (size_t k = 0; k < unplaced.size(); k++) {
+                seats[unplaced[k]] = together[k];
+            }
+        } else {
+            allocated = false;
+        }
+    }
     
+    if (!allocated) {
+        for (const auto& seat : claimed) {
+            seatMap->release(seat);
+        }
+        return false;
+    }
+    
+    labelSeats(passengers, seats, seatMap->getLayout());
+    return true;
+}
+
+void SeatAllocationService::labelSeats(std::vector<Passenger>& passengers,
+                                       const std::vector<SeatRef>& seats,
+                                       const CoachLayout& layout) {
+    // Prefix and berth come from the class layout, no class lookups per passenger
     for (size_t i = 0; i < passengers.size(); i++) {
-        int seatNumber = startSeat + i;
-        
         // Generate seat assignment
         std::ostringstream oss;
-        oss << coachPrefix << coachNumber << "-" << seatNumber;
+        oss << layout.coachPrefix << seats[i].coach << "-" << seats[i].seat;
         passengers[i].setAssignedSeat(oss.str());
         
         // Assign berth type
-        std::string berthType = getBerthType(seatNumber, classCode);
-        passengers[i].setAssignedBerth(berthType);
+        passengers[i].setAssignedBerth(berthTypeName(layout.berthAt(seats[i].seat)));
+    }
+}
+
+bool SeatAllocationService::assignSegmentSeats(std::vector<Passenger>& passengers,
+                                               const Train& train,
+                                               const std::string& journeyDate,
+                                               const std::string& classCode,
+                                               int fromStop,
+                                               int toStop,
+                                               int& freshSeats) {
+    SeatMap* seatMap = SeatMapRegistry::getInstance()->getMap(train, journeyDate, classCode);
+    if (!seatMap) {
+        return false;
+    }
+    
+    std::vector<SeatRef> seats;
+    if (!seatMap->allocateSegment(fromStop, toStop, static_cast<int>(passengers.size()), seats, freshSeats)) {
+        return false;
     }
     
+    labelSeats(passengers, seats, seatMap->getLayout());
     return true;
 }
+
+void SeatAllocationService::releaseSeats(const std::vector<Passenger>& passengers,
+                                         const Train& train,
+                                         const std::string& journeyDate,
+                                         const std::string& classCode) {
+    SeatMap* seatMap = SeatMapRegistry::getInstance()->getMap(train, journeyDate, classCode);
+    if (!seatMap) {
+        return;
+    }
+    
+    for (const auto& passenger : passengers) {
+        SeatRef seat;
+        if (parseSeatLabel(passenger.getAssignedSeat(), seat)) {
+            seatMap->release(seat);
+        }
+    }
+}
+
+int SeatAllocationService::releaseSegmentSeats(const std::vector<Passenger>& passengers,
+                                               const Train& train,
+                                               const std::string& journeyDate,
+                                               const std::string& classCode,
+                                               int fromStop,
+                                               int toStop) {
+    SeatMap* seatMap = SeatMapRegistry::getInstance()->getMap(train, journeyDate, classCode);
+    if (!seatMap) {
+        return 0;
+    }
+    
+    int freed = 0;
+    for (const auto& passenger : passengers) {
+        SeatRef seat;
+        if (parseSeatLabel(passenger.getAssignedSeat(), seat) &&
+            seatMap->releaseSegment(seat, fromStop, toStop)) {
+            freed++;
+        }
+    }
+    return freed;
+}
+
+bool SeatAllocationService::rebalanceBooking(const std::string& bookingId) {
+    DataStore* store = DataStore::getInstance();
+    Booking* stored = store->findBookingById(bookingId);
+    if (!stored) {
+        return false;
+    }
+    Booking booking = *stored;
+    if (booking.getStatus() != "Confirmed" || booking.isPartialJourney()) {
+        return false;
+    }
+    
+    SeatMap* seatMap = SeatMapRegistry::getInstance()->getMap(
+        booking.getTrain(), booking.getJourneyDate(), booking.getClassCode());
+    if (!seatMap) {
+        return false;
+    }
+    
+    // Leave headroom so a move never takes the last seats a booking in
+    // flight has already counted on
+    if (seatMap->countFreeSeats() < 2 * SeatMap::MAX_GROUP_SIZE) {
+        return false;
+    }
+    
+    std::vector<Passenger> passengers = booking.getPassengers();
+    std::vector<Passenger> seated;
+    std::vector<size_t> seatedIndex;
+    std::vector<SeatRef> seats;
+    bool choseBerths = false;
+    for (size_t i = 0; i < passengers.size(); i++) {
+        SeatRef seat;
+        if (!passengers[i].isCancelled() && parseSeatLabel(passengers[i].getAssignedSeat(), seat)) {
+            seated.push_back(passengers[i]);
+            seatedIndex.push_back(i);
+            seats.push_back(seat);
+        }
+        BerthType preferred;
+        choseBerths = choseBerths || parseBerthType(passengers[i].getBerthPreference(), preferred);
+    }
+    
+    // A party that chose berths keeps them; a single passenger keeps the
+    // berth type either way
+    std::vector<SeatRef> targets;
+    if (seats.size() == 1) {
+        targets.resize(1);
+        if (!seatMap->claimCompaction(seats[0], targets[0])) {
+            return false;
+        }
+    } else if (choseBerths || !seatMap->claimRegroup(seats, targets)) {
+        return false;
+    }
+    
+    std::vector<Passenger> relabeled = seated;
+    labelSeats(relabeled, targets, seatMap->getLayout());
+    
+    // Commit only if nothing changed the seats since they were read; a
+    // cancellation in between keeps the old seats and drops the new ones
+    bool committed = false;
+    store->modifyBooking(bookingId, [&](Booking& current) {
+        std::vector<Passenger> now = current.getPassengers();
+        if (current.getStatus() != "Confirmed" || now.size() != passengers.size()) {
+            return;
+        }
+        for (size_t k = 0; k < seatedIndex.size(); k++) {
+            const Passenger& passenger = now[seatedIndex[k]];
+            if (passenger.isCancelled() || passenger.getAssignedSeat() != seated[k].getAssignedSeat()) {
+                return;
+            }
+        }
+        for (size_t k = 0; k < seatedIndex.size(); k++) {
+            now[seatedIndex[k]].setAssignedSeat(relabeled[k].getAssignedSeat());
+            now[seatedIndex[k]].setAssignedBerth(relabeled[k].getAssignedBerth());
+        }
+        current.setPassengers(now);
+        committed = true;
+    });
+    
+    for (size_t k = 0; k < seats.size(); k++) {
+        bool moved = seats[k].coach != targets[k].coach || seats[k].seat != targets[k].seat;
+        if (moved) {
+            seatMap->release(committed ? seats[k] : targets[k]);
+        }
+    }
+    return committed;
+}
+
+nlohmann::json SeatAllocationService::describeSeatMap(const Train& train,
+                                                      const std::string& journeyDate,
+                                                      const std::string& classCode,
+                                                      int fromStop,
+                                                      int toStop) {
+    // A read never creates the date's map; until a booking does, show the
+    // seats as a new map would start out
+    SeatMap* seatMap = SeatMapRegistry::getInstance()->findMap(train, journeyDate, classCode);
+    std::unique_ptr<SeatMap> preview;
+    if (!seatMap) {
+        preview = SeatMapRegistry::previewMap(train, journeyDate, classCode);
+        if (!preview) {
+            return nullptr;
+        }
+        seatMap = preview.get();
+    }
+    
+    const CoachLayout& layout = seatMap->getLayout();
+    uint8_t bytes[SeatMap::MAX_SEATS_PER_COACH / 8];
+    size_t byteCount = static_cast<size_t>(layout.seatsPerCoach + 7) / 8;
+    
+    nlohmann::json coaches = nlohmann::json::array();
+    for (int c = 0; c < seatMap->getCoachCount(); c++) {
+        seatMap->snapshotCoach(c, fromStop, toStop, bytes);
+        coaches.push_back(Crypto::base64Encode(bytes, byteCount));
+    }
+    
+    return {
+        {"layoutId", layout.id},
+        {"coachPrefix", layout.coachPrefix},
+        {"seatsPerCoach", layout.seatsPerCoach},
+        {"coaches", coaches}
+    };
+}
@@ -0,0 +1,133 @@
+#include "utils/BookingSequencer.h"
+#include <iostream>
+
+// MpscTaskQueue Implementation
+MpscTaskQueue::MpscTaskQueue() : head(&stub), tail(&stub) {
+    stub.next.store(nullptr, std::memory_order_relaxed);
+}
+
+void MpscTaskQueue::push(Node* node) {
+    node->next.store(nullptr, std::memory_order_relaxed);
+    Node* previous = head.exchange(node, std::memory_order_acq_rel);
+    previous->next.store(node, std::memory_order_release);
+}
+
+MpscTaskQueue::Node* MpscTaskQueue::pop() {
+    Node* current = tail;
+    Node* next = current->next.load(std::memory_order_acquire);
+    
+    // Skip over the stub node
+    if (current == &stub) {
+        if (!next) {
+            return nullptr;
+        }
+        tail = next;
+        current = next;
+        next = next->next.load(std::memory_order_acquire);
+    }
+    
+    if (next) {
+        tail = next;
+        return current;
+    }
+    
+    // A producer has swapped head but not linked its node yet
+    if (current != head.load(std::memory_order_acquire)) {
+        return nullptr;
+    }
+    
+    // Last real node: re-insert the stub so it can be detached
+    push(&stub);
+    next = current->next.load(std::memory_order_acquire);
+    if (next) {
+        tail = next;
+        return current;
+    }
+    return nullptr;
+}
+
+// BookingSequencer Implementation
+BookingSequencer::BookingSequencer() : stopping(false) {
+    for (size_t i = 0; i < SHARD_COUNT; i++) {
+        shards[i].reset(new Shard());
+        Shard* shard = shards[i].get();
+        shard->worker = std::thread([this, shard]() { runShard(*shard); });
+    }
+}
+
+BookingSequencer::~BookingSequencer() {
+    stopping.store(true);
+    for (size_t i = 0; i < SHARD_COUNT; i++) {
+        {
+            std::lock_guard<std::mutex> lock(shards[i]->sleepMutex);
+        }
+        shards[i]->wakeup.notify_one();
+        if (shards[i]->worker.joinable()) {
+            shards[i]->worker.join();
+        }
+    }
+}
+
+BookingSequencer* BookingSequencer::getInstance() {
+    static BookingSequencer instance;
+    return &instance;
+}
+
+void BookingSequencer::submit(const std::string& trainNumber, std::function<void()> task) {
+    Shard& shard = *shards[std::hash<std::string>()(trainNumber) % SHARD_COUNT];
+    
+    MpscTaskQueue::Node* node = new MpscTaskQueue::Node();
+    node->task = std::move(task);
+    shard.queue.push(node);
+    shard.pending.fetch_add(1);
+    
+    // Only pay for the mutex when the worker is parked
+    if (shard.sleeping.load()) {
+        {
+            std::lock_guard<std::mutex> lock(shard.sleepMutex);
+        }
+        shard.wakeup.notify_one();
+    }
+}
+
+void BookingSequencer::runShard(Shard& shard) {
+    std::vector<MpscTaskQueue::Node*> batch;
+    batch.reserve(BATCH_SIZE);
+    
+    while (true) {
+        // Drain a batch, then apply it in arrival order
+        while (batch.size() < BATCH_SIZE) {
+            MpscTaskQueue::Node* node = shard.queue.pop();
+            if (!node) break;
+            batch.push_back(node);
+        }
+        
+        for (MpscTaskQueue::Node* node : batch) {
+            node->task();
+            delete node;
+        }
+        
+        if (!batch.empty()) {
+            shard.pending.fetch_sub(batch.size());
+            batch.clear();
+            continue;
+        }
+        
+        if (shard.pending.load() > 0) {
+            // A push is mid-flight; its node becomes visible shortly
+            std::this_thread::yield();
+            continue;
+        }
+        
+        if (stopping.load()) {
+            break;
+        }
+        
+        std::unique_lock<std::mutex> lock(shard.sleepMutex);
+        shard.sleeping.store(true);
+        shard.wakeup.wait(lock, [&shard, this]() {
+            return shard.pending.load() > 0 || stopping.load();
+        });
+        shard.sleeping.store(false);
+    }
+}
@@ -0,0 +1,25 @@
+#include "utils/CoachLayout.h"
+
+namespace {
+
+const char* const BERTH_TYPE_NAMES[BERTH_TYPE_COUNT] = {
+    "Lower", "Middle", "Upper", "Side Lower", "Side Upper", "Seat"
+};
+
+}
+
+bool parseBerthType(const std::string& name, BerthType& type) {
+    // Seat is assigned, never requested
+    for (int i = 0; i < static_cast<int>(BerthType::Seat); i++) {
+        if (name == BERTH_TYPE_NAMES[i]) {
+            type = static_cast<BerthType>(i);
+            return true;
+        }
+    }
+    return false;
+}
+
+const char* berthTypeName(BerthType type) {
+    int index = static_cast<int>(type);
+    return index < BERTH_TYPE_COUNT ? BERTH_TYPE_NAMES[index] : "Seat";
+}
@@ -0,0 +1,64 @@
+#include "utils/Config.h"
+#include <fstream>
+#include <iostream>
+
+Config* Config::instance = nullptr;
+
+Config::Config() : values(nlohmann::json::object()) {}
+
+Config* Config::getInstance() {
+    if (instance == nullptr) {
+        instance = new Config();
+    }
+    return instance;
+}
+
+bool Config::load(const std::string& path) {
+    std::ifstream file(path);
+    if (!file.is_open()) {
+        std::cerr << "Config file not found: " << path << ", using defaults" << std::endl;
+        return false;
+    }
+    
+    try {
+        values = nlohmann::json::parse(file);
+    } catch (const std::exception& e) {
+        std::cerr << "Failed to parse " << path << ": " << e.what() << std::endl;
+        values = nlohmann::json::object();
+        return false;
+    }
+    
+    return true;
+}
+
+int Config::getInt(const std::string& key, int defaultValue) const {
+    nlohmann::json::json_pointer pointer(key);
+    if (values.contains(pointer) && values[pointer].is_number()) {
+        return values[pointer].get<int>();
+    }
+    return defaultValue;
+}
+
+double Config::getDouble(const std::string& key, double defaultValue) const {
+    nlohmann::json::json_pointer pointer(key);
+    if (values.contains(pointer) && values[pointer].is_number()) {
+        return values[pointer].get<double>();
+    }
+    return defaultValue;
+}
+
+bool Config::getBool(const std::string& key, bool defaultValue) const {
+    nlohmann::json::json_pointer pointer(key);
+    if (values.contains(pointer) && values[pointer].is_boolean()) {
+        return values[pointer].get<bool>();
+    }
+    return defaultValue;
+}
+
+std::string Config::getString(const std::string& key, const std::string& defaultValue) const {
+    nlohmann::json::json_pointer pointer(key);
+    if (values.contains(pointer) && values[pointer].is_string()) {
+        return values[pointer].get<std::string>();
+    }
+    return defaultValue;
+}
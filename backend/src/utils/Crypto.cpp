@@ -0,0 +1,109 @@
+#include "utils/Crypto.h"
+#include <openssl/hmac.h>
+#include <openssl/evp.h>
+#include <openssl/rand.h>
+#include <openssl/crypto.h>
+#include <openssl/sha.h>
+#include <algorithm>
+#include <memory>
+#include <random>
+
+namespace Crypto {
+
+namespace {
+
+std::string toHex(const unsigned char* bytes, unsigned int length) {
+    static const char* hexChars = "0123456789abcdef";
+    std::string hex(length * 2, '0');
+    for (unsigned int i = 0; i < length; i++) {
+        hex[2 * i] = hexChars[bytes[i] >> 4];
+        hex[2 * i + 1] = hexChars[bytes[i] & 0x0f];
+    }
+    return hex;
+}
+
+}
+
+std::string hmacSha256Hex(const std::string& key, const std::string& data) {
+    unsigned char digest[EVP_MAX_MD_SIZE];
+    unsigned int length = 0;
+    
+    HMAC(EVP_sha256(), key.data(), static_cast<int>(key.size()),
+         reinterpret_cast<const unsigned char*>(data.data()), data.size(),
+         digest, &length);
+    return toHex(digest, length);
+}
+
+HmacSha256::HmacSha256(const std::string& key)
+    : inner(EVP_MD_CTX_new()), outer(EVP_MD_CTX_new()) {
+    // RFC 2104: keys longer than a block are hashed first
+    unsigned char block[SHA256_CBLOCK] = {0};
+    if (key.size() > sizeof(block)) {
+        unsigned int length = 0;
+        EVP_Digest(key.data(), key.size(), block, &length, EVP_sha256(), nullptr);
+    } else {
+        std::copy(key.begin(), key.end(), block);
+    }
+    
+    unsigned char innerPad[SHA256_CBLOCK];
+    unsigned char outerPad[SHA256_CBLOCK];
+    for (size_t i = 0; i < sizeof(block); i++) {
+        innerPad[i] = block[i] ^ 0x36;
+        outerPad[i] = block[i] ^ 0x5c;
+    }
+    EVP_DigestInit_ex(inner, EVP_sha256(), nullptr);
+    EVP_DigestUpdate(inner, innerPad, sizeof(innerPad));
+    EVP_DigestInit_ex(outer, EVP_sha256(), nullptr);
+    EVP_DigestUpdate(outer, outerPad, sizeof(outerPad));
+    OPENSSL_cleanse(block, sizeof(block));
+}
+
+HmacSha256::~HmacSha256() {
+    EVP_MD_CTX_free(inner);
+    EVP_MD_CTX_free(outer);
+}
+
+std::string HmacSha256::hex(const std::string& data) const {
+    // One scratch context per thread; the keyed states are only read
+    thread_local std::unique_ptr<EVP_MD_CTX, void (*)(EVP_MD_CTX*)> work(EVP_MD_CTX_new(), EVP_MD_CTX_free);
+    
+    unsigned char innerDigest[EVP_MAX_MD_SIZE];
+    unsigned char digest[EVP_MAX_MD_SIZE];
+    unsigned int length = 0;
+    EVP_MD_CTX_copy_ex(work.get(), inner);
+    EVP_DigestUpdate(work.get(), data.data(), data.size());
+    EVP_DigestFinal_ex(work.get(), innerDigest, &length);
+    EVP_MD_CTX_copy_ex(work.get(), outer);
+    EVP_DigestUpdate(work.get(), innerDigest, length);
+    EVP_DigestFinal_ex(work.get(), digest, &length);
+    return toHex(digest, length);
+}
+
+bool constantTimeEquals(const std::string& a, const std::string& b) {
+    if (a.size() != b.size()) {
+        return false;
+    }
+    return CRYPTO_memcmp(a.data(), b.data(), a.size()) == 0;
+}
+
+std::string randomBytes(size_t count) {
+    std::string bytes(count, '\0');
+    if (RAND_bytes(reinterpret_cast<unsigned char*>(&bytes[0]), static_cast<int>(count)) != 1) {
+        // Fall back to the OS entropy source
+        std::random_device rd;
+        for (auto& byte : bytes) {
+            byte = static_cast<char>(rd());
+        }
+    }
+    return bytes;
+}
+
+std::string base64Encode(const unsigned char* data, size_t length) {
+    std::string encoded(4 * ((length + 2) / 3), '\0');
+    int written = EVP_EncodeBlock(reinterpret_cast<unsigned char*>(&encoded[0]), data,
+                                  static_cast<int>(length));
+    encoded.resize(written > 0 ? static_cast<size_t>(written) : 0);
+    return encoded;
+}
+
+}
@@ -1,5 +1,9 @@
 #include "utils/DataStore.h"
+#include "utils/EventBus.h"
+#include "utils/Config.h"
+#include "utils/DateUtils.h"
 #include <algorithm>
+#include <cmath>
 #include <iostream>
 #include <cstdlib>
 #include <ctime>
@@ -9,6 +13,10 @@ DataStore* DataStore::instance = nullptr;
 DataStore::DataStore() {
     // Initialize random seed for generating varied availability data
     std::srand(static_cast<unsigned int>(std::time(nullptr)));
+    
+    Config* config = Config::getInstance();
+    sessionTtlSeconds = std::max(1, config->getInt("/security/tokenExpiry", 86400));
+    maxSessions = static_cast<size_t>(std::max(1, config->getInt("/security/maxSessions", 100000)));
 }
 
 DataStore* DataStore::getInstance() {
@@ -82,9 +90,13 @@ bool DataStore::addTrain(const Train& train) {
     
     trains[train.getTrainNumber()] = train;
     
-    // Add to route index
-    std::string routeKey = train.getFromStation() + "|" + train.getToStation();
-    trainsByRoute[routeKey].push_back(train.getTrainNumber());
+    // Add to route index under every pair of stops it serves in order
+    std::vector<std::string> stops = train.getStops();
+    for (size_t i = 0; i < stops.size(); i++) {
+        for (size_t j = i + 1; j < stops.size(); j++) {
+            trainsByRoute[stops[i] + "|" + stops[j]].push_back(train.getTrainNumber());
+        }
+    }
     
     return true;
 }
@@ -120,6 +132,59 @@ std::vector<Train> DataStore::searchTrains(const std::string& from, const std::s
     return results;
 }
 
+std::vector<AvailabilityRow> DataStore::getRouteAvailabilityRows(const std::string& from, 
+                                                                 const std::string& to) {
+    std::lock_guard<std::mutex> lock(trainMutex);
+    
+    std::vector<AvailabilityRow> rows;
+    
+    auto it = trainsByRoute.find(from + "|" + to);
+    if (it == trainsByRoute.end()) {
+        return rows;
+    }
+    
+    // One row per (train, class) without copying the Train objects
+    for (const auto& trainNumber : it->second) {
+        auto trainIt = trains.find(trainNumber);
+        if (trainIt == trains.end()) continue;
+        
+        const Train& train = trainIt->second;
+        int departureMinutes = DateUtils::parseClockMinutes(train.getDepartureTime());
+        const auto& availability = train.getAvailabilityRef();
+        
+        // Part of a longer route: segment fare, and no known duration
+        int fromStop = train.getStopIndex(from);
+        int toStop = train.getStopIndex(to);
+        bool fullRoute = fromStop == 0 && toStop == train.getLegCount();
+        double share = train.getSegmentShare(fromStop, toStop);
+        
+        for (size_t slot = 0; slot < availability.size(); slot++) {
+            AvailabilityRow row;
+            row.train = &train;
+            row.classSlot = static_cast<uint16_t>(slot);
+            row.availableSeats = availability[slot].availableSeats;
+            row.durationMinutes = fullRoute ? train.getDurationMinutes() : -1;
+            row.departureMinutes = departureMinutes;
+            row.price = fullRoute ? availability[slot].price : std::round(availability[slot].price * share);
+            rows.push_back(row);
+        }
+    }
+    
+    return rows;
+}
+
+std::vector<std::pair<std::string, std::string>> DataStore::getRoutes() {
+    std::lock_guard<std::mutex> lock(trainMutex);
+    
+    std::vector<std::pair<std::string, std::string>> routes;
+    routes.reserve(trainsByRoute.size());
+    for (const auto& entry : trainsByRoute) {
+        size_t separator = entry.first.find('|');
+        routes.emplace_back(entry.first.substr(0, separator), entry.first.substr(separator + 1));
+    }
+    return routes;
+}
+
 bool DataStore::updateTrain(const Train& train) {
     std::lock_guard<std::mutex> lock(trainMutex);
     
@@ -131,6 +196,13 @@ bool DataStore::updateTrain(const Train& train) {
     return false;
 }
 
+void DataStore::forEachTrain(const std::function<void(Train&)>& visitor) {
+    std::lock_guard<std::mutex> lock(trainMutex);
+    for (auto& entry : trains) {
+        visitor(entry.second);
+    }
+}
+
 // Booking Operations
 bool DataStore::addBooking(const Booking& booking) {
     std::lock_guard<std::mutex> lock(bookingMutex);
@@ -139,6 +211,10 @@ bool DataStore::addBooking(const Booking& booking) {
     bookingsByUser[booking.getUserId()].push_back(booking.getBookingId());
     pnrToBookingId[booking.getPnr()] = booking.getBookingId();
     
+    // Published under the lock so consumers see one booking's events in order
+    EventBus::getInstance()->publish(
+        BookingEvent::forBooking(BookingEventType::BookingCreated, booking));
+    
     return true;
 }
 
@@ -190,11 +266,55 @@ bool DataStore::updateBooking(const Booking& booking) {
     auto it = bookingsById.find(booking.getBookingId());
     if (it != bookingsById.end()) {
         it->second = booking;
+        EventBus::getInstance()->publish(
+            BookingEvent::forBooking(BookingEventType::BookingUpdated, booking));
         return true;
     }
     return false;
 }
 
+bool DataStore::modifyBooking(const std::string& bookingId, 
+                              const std::function<void(Booking&)>& mutator) {
+    std::lock_guard<std::mutex> lock(bookingMutex);
+    
+    auto it = bookingsById.find(bookingId);
+    if (it == bookingsById.end()) {
+        return false;
+    }
+    
+    mutator(it->second);
+    
+    const Booking& updated = it->second;
+    EventBus::getInstance()->publish(BookingEvent::forBooking(
+        updated.getStatus() == "Cancelled" ? BookingEventType::BookingCancelled 
+                                           : BookingEventType::BookingUpdated,
+        updated));
+    return true;
+}
+
+bool DataStore::transitionBookingStatus(const std::string& bookingId, 
+                                        const std::string& newStatus,
+                                        std::string& previousStatus) {
+    std::lock_guard<std::mutex> lock(bookingMutex);
+    
+    auto it = bookingsById.find(bookingId);
+    if (it == bookingsById.end()) {
+        return false;
+    }
+    
+    previousStatus = it->second.getStatus();
+    if (previousStatus == newStatus) {
+        return false; // Already in the requested state
+    }
+    
+    it->second.setStatus(newStatus);
+    EventBus::getInstance()->publish(BookingEvent::forBooking(
+        newStatus == "Cancelled" ? BookingEventType::BookingCancelled 
+                                 : BookingEventType::BookingUpdated,
+        it->second));
+    return true;
+}
+
 bool DataStore::deleteBooking(const std::string& bookingId) {
     std::lock_guard<std::mutex> lock(bookingMutex);
     
@@ -215,18 +335,62 @@ bool DataStore::deleteBooking(const std::string& bookingId) {
     return false;
 }
 
+void DataStore::forEachBooking(const std::function<void(const Booking&)>& visitor) {
+    std::lock_guard<std::mutex> lock(bookingMutex);
+    for (const auto& entry : bookingsById) {
+        visitor(entry.second);
+    }
+}
+
 // Session Operations
+void DataStore::sweepSessionsLocked(std::time_t now) {
+    // Expired sessions, then the oldest while over the cap; the cap counts
+    // live sessions, not stale queue entries
+    while (!sessionExpiry.empty()) {
+        const auto& front = sessionExpiry.front();
+        auto it = activeSessions.find(front.second);
+        bool live = it != activeSessions.end() && it->second.expiresAt == front.first;
+        if (live && front.first > now && activeSessions.size() <= maxSessions) {
+            break;
+        }
+        if (live) {
+            activeSessions.erase(it);
+        }
+        sessionExpiry.pop_front();
+    }
+    
+    // Every live session has one entry, so past twice the cap at least
+    // half are stale; dropping them keeps the queue bounded at O(1) a login
+    if (sessionExpiry.size() > 2 * maxSessions) {
+        std::deque<std::pair<std::time_t, std::string>> live;
+        for (const auto& entry : sessionExpiry) {
+            auto it = activeSessions.find(entry.second);
+            if (it != activeSessions.end() && it->second.expiresAt == entry.first) {
+                live.push_back(entry);
+            }
+        }
+        sessionExpiry.swap(live);
+    }
+}
+
 void DataStore::addSession(const std::string& token, const std::string& userId) {
     std::lock_guard<std::mutex> lock(sessionMutex);
-    activeSessions[token] = userId;
+    
+    // Each login pays for the sessions that expired before it
+    std::time_t now = std::time(nullptr);
+    std::time_t expiresAt = now + sessionTtlSeconds;
+    activeSessions[token] = {userId, expiresAt};
+    sessionExpiry.emplace_back(expiresAt, token);
+    sweepSessionsLocked(now);
 }
 
 std::string DataStore::getUserIdFromToken(const std::string& token) {
+    std::time_t now = std::time(nullptr);
     std::lock_guard<std::mutex> lock(sessionMutex);
     
     auto it = activeSessions.find(token);
-    if (it != activeSessions.end()) {
-        return it->second;
+    if (it != activeSessions.end() && it->second.expiresAt > now) {
+        return it->second.userId;
     }
     return "";
 }
@@ -504,11 +668,50 @@ void DataStore::initializeSampleData() {
         {"12616", "Grand Trunk Express", "New Delhi (NDLS)", "Chennai (MAS)", "19:15", "07:40", "36h 25m"}
     };
     
+    // Intermediate stops of the premium trains, listed for the first train
+    // of each pair; the return train calls at them in reverse
+    std::vector<std::tuple<std::string, std::string, std::vector<std::string>>> premiumStops = {
+        {"12001", "12002", {"Agra (AGC)"}},
+        {"12951", "12952", {"Surat (ST)", "Vadodara (BRC)"}},
+        {"12953", "12954", {"Surat (ST)", "Vadodara (BRC)"}},
+        {"12301", "12302", {"Allahabad (PRYJ)", "Kanpur (CNB)"}},
+        {"22691", "22692", {"Hyderabad (SC)", "Nagpur (NGP)", "Bhopal (BPL)", "Agra (AGC)"}},
+        {"12137", "12138", {"Nashik (NK)", "Bhopal (BPL)", "Agra (AGC)", "New Delhi (NDLS)"}},
+        {"12723", "12724", {"Nagpur (NGP)", "Bhopal (BPL)", "Agra (AGC)"}},
+        {"12861", "12862", {"Bhubaneswar (BBS)", "Vijayawada (BZA)"}},
+        {"12841", "12842", {"Vijayawada (BZA)", "Bhubaneswar (BBS)"}},
+        {"12625", "12626", {"Agra (AGC)", "Bhopal (BPL)", "Nagpur (NGP)", "Vijayawada (BZA)",
+                            "Coimbatore (CBE)", "Kochi (ERN)"}},
+        {"12903", "12904", {"Surat (ST)", "Vadodara (BRC)", "New Delhi (NDLS)"}},
+        {"12321", "12322", {"Allahabad (PRYJ)", "Jabalpur (JBP)", "Nashik (NK)"}},
+        {"12471", "12472", {"Surat (ST)", "Vadodara (BRC)", "New Delhi (NDLS)"}},
+        {"12801", "12802", {"Bhubaneswar (BBS)", "Allahabad (PRYJ)", "Kanpur (CNB)"}},
+        {"12779", "12780", {"Pune (PUNE)", "Bhopal (BPL)", "Agra (AGC)"}},
+        {"12565", "12566", {"Gorakhpur (GKP)", "Lucknow (LKO)"}},
+        {"12009", "12010", {"Surat (ST)", "Vadodara (BRC)"}},
+        {"12833", "12834", {"Nagpur (NGP)", "Raipur (R)"}},
+        {"15657", "15658", {"Lucknow (LKO)", "Gorakhpur (GKP)"}},
+        {"12915", "12916", {"Jaipur (JP)"}},
+        {"12615", "12616", {"Vijayawada (BZA)", "Nagpur (NGP)", "Bhopal (BPL)", "Agra (AGC)"}}
+    };
+    
+    std::unordered_map<std::string, std::vector<std::string>> viaByTrain;
+    for (const auto& entry : premiumStops) {
+        const std::vector<std::string>& via = std::get<2>(entry);
+        viaByTrain[std::get<0>(entry)] = via;
+        viaByTrain[std::get<1>(entry)] = std::vector<std::string>(via.rbegin(), via.rend());
+    }
+    
     // Add premium trains with fixed details
     for (const auto& td : premiumTrainData) {
         Train train(std::get<0>(td), std::get<1>(td));
         train.setFromStation(std::get<2>(td));
         train.setToStation(std::get<3>(td));
+        
+        auto via = viaByTrain.find(std::get<0>(td));
+        if (via != viaByTrain.end()) {
+            train.setViaStations(via->second);
+        }
         train.setDepartureTime(std::get<4>(td));
         train.setArrivalTime(std::get<5>(td));
         train.setDuration(std::get<6>(td));
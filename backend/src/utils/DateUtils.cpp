@@ -0,0 +1,96 @@
+#include "utils/DateUtils.h"
+#include <cstdio>
+#include <ctime>
+
+namespace DateUtils {
+
+// Civil calendar conversions (proleptic Gregorian)
+static int daysFromCivil(int y, unsigned m, unsigned d) {
+    y -= m <= 2;
+    const int era = (y >= 0 ? y : y - 399) / 400;
+    const unsigned yoe = static_cast<unsigned>(y - era * 400);
+    const unsigned doy = (153 * (m + (m > 2 ? -3 : 9)) + 2) / 5 + d - 1;
+    const unsigned doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+    return era * 146097 + static_cast<int>(doe) - 719468;
+}
+
+static void civilFromDays(int z, int& y, unsigned& m, unsigned& d) {
+    z += 719468;
+    const int era = (z >= 0 ? z : z - 146096) / 146097;
+    const unsigned doe = static_cast<unsigned>(z - era * 146097);
+    const unsigned yoe = (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365;
+    const unsigned doy = doe - (365 * yoe + yoe / 4 - yoe / 100);
+    const unsigned mp = (5 * doy + 2) / 153;
+    d = doy - (153 * mp + 2) / 5 + 1;
+    m = mp < 10 ? mp + 3 : mp - 9;
+    y = static_cast<int>(yoe) + era * 400 + (m <= 2);
+}
+
+static int digitsAt(const std::string& text, size_t pos, size_t count) {
+    int value = 0;
+    for (size_t i = pos; i < pos + count; i++) {
+        if (text[i] < '0' || text[i] > '9') {
+            return -1;
+        }
+        value = value * 10 + (text[i] - '0');
+    }
+    return value;
+}
+
+bool parseDate(const std::string& date, int& dayNumber) {
+    // Canonical YYYY-MM-DD only, so one day always has one spelling
+    if (date.length() != 10 || date[4] != '-' || date[7] != '-') {
+        return false;
+    }
+    int y = digitsAt(date, 0, 4);
+    int month = digitsAt(date, 5, 2);
+    int day = digitsAt(date, 8, 2);
+    if (y < 0 || month < 0 || day < 0) {
+        return false;
+    }
+    unsigned m = static_cast<unsigned>(month), d = static_cast<unsigned>(day);
+    if (m < 1 || m > 12 || d < 1 || d > 31) {
+        return false;
+    }
+    
+    dayNumber = daysFromCivil(y, m, d);
+    
+    // Reject dates such as 2025-02-30 that roll over
+    int cy;
+    unsigned cm, cd;
+    civilFromDays(dayNumber, cy, cm, cd);
+    return cy == y && cm == m && cd == d;
+}
+
+std::string formatDate(int dayNumber) {
+    int y;
+    unsigned m, d;
+    civilFromDays(dayNumber, y, m, d);
+    
+    // Sized for any int year, not just four digits
+    char buffer[32];
+    std::snprintf(buffer, sizeof(buffer), "%04d-%02u-%02u", y, m, d);
+    return std::string(buffer);
+}
+
+int today() {
+    return static_cast<int>(std::time(nullptr) / 86400);
+}
+
+int parseDurationMinutes(const std::string& duration) {
+    int hours = 0, minutes = 0;
+    if (std::sscanf(duration.c_str(), "%dh %dm", &hours, &minutes) != 2) {
+        return -1;
+    }
+    return hours * 60 + minutes;
+}
+
+int parseClockMinutes(const std::string& time) {
+    int hours = 0, minutes = 0;
+    if (std::sscanf(time.c_str(), "%d:%d", &hours, &minutes) != 2) {
+        return -1;
+    }
+    return hours * 60 + minutes;
+}
+
+} // namespace DateUtils
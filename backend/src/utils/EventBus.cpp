@@ -0,0 +1,259 @@
+#include "utils/EventBus.h"
+#include "utils/Config.h"
+#include <chrono>
+#include <cstring>
+#include <iostream>
+#include <type_traits>
+
+static_assert(std::is_trivially_copyable<BookingEvent>::value, 
+              "Events are copied out of the ring without locks");
+
+namespace {
+
+template <size_t N>
+void copyField(char (&field)[N], const std::string& value) {
+    size_t length = value.size() < N - 1 ? value.size() : N - 1;
+    std::memcpy(field, value.data(), length);
+    field[length] = '\0';
+}
+
+int64_t nowMs() {
+    return std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+}
+
+}
+
+BookingEvent BookingEvent::forBooking(BookingEventType type, const Booking& booking) {
+    BookingEvent event;
+    std::memset(&event, 0, sizeof(event));
+    
+    event.type = type;
+    event.timestampMs = nowMs();
+    copyField(event.bookingId, booking.getBookingId());
+    copyField(event.pnr, booking.getPnr());
+    copyField(event.userId, booking.getUserId());
+    copyField(event.trainNumber, booking.getTrain().getTrainNumber());
+    copyField(event.journeyDate, booking.getJourneyDate());
+    copyField(event.classCode, booking.getClassCode());
+    copyField(event.quota, booking.getQuota());
+    copyField(event.status, booking.getStatus());
+    event.totalFare = booking.getTotalFare();
+    event.available = -1;
+    
+    const std::vector<Passenger> passengers = booking.getPassengers();
+    event.seats = static_cast<int32_t>(passengers.size());
+    event.passengerCount = static_cast<uint8_t>(
+        passengers.size() < MAX_PASSENGERS ? passengers.size() : MAX_PASSENGERS);
+    
+    for (uint8_t i = 0; i < event.passengerCount; i++) {
+        copyField(event.passengers[i].seat, passengers[i].getAssignedSeat());
+        copyField(event.passengers[i].berth, passengers[i].getAssignedBerth());
+        event.passengers[i].cancelled = passengers[i].isCancelled();
+    }
+    
+    return event;
+}
+
+BookingEvent BookingEvent::forInventory(BookingEventType type, const std::string& trainNumber,
+                                        const std::string& journeyDate, const std::string& classCode,
+                                        int seats, int available) {
+    BookingEvent event;
+    std::memset(&event, 0, sizeof(event));
+    
+    event.type = type;
+    event.timestampMs = nowMs();
+    copyField(event.trainNumber, trainNumber);
+    copyField(event.journeyDate, journeyDate);
+    copyField(event.classCode, classCode);
+    event.seats = seats;
+    event.available = available;
+    
+    return event;
+}
+
+EventBus::EventBus() : nextSequence(0), stopping(false), idleConsumers(0) {
+    // Power of two so a sequence maps to its slot with a mask
+    int requested = Config::getInstance()->getInt("/events/ringCapacity", 4096);
+    capacity = 1024;
+    while (capacity < static_cast<size_t>(requested) && capacity < (1u << 20)) {
+        capacity <<= 1;
+    }
+    mask = capacity - 1;
+    
+    slots.reset(new Slot[capacity]);
+    for (size_t i = 0; i < capacity; i++) {
+        slots[i].stamp.store(0, std::memory_order_relaxed);
+    }
+}
+
+EventBus::~EventBus() {
+    stopping = true;
+    {
+        std::lock_guard<std::mutex> lock(idleMutex);
+        idleCv.notify_all();
+    }
+    for (auto& subscription : subscriptions) {
+        if (subscription->worker.joinable()) {
+            subscription->worker.join();
+        }
+    }
+}
+
+EventBus* EventBus::getInstance() {
+    static EventBus instance;
+    return &instance;
+}
+
+void EventBus::publish(BookingEvent event) {
+    uint64_t sequence = nextSequence.fetch_add(1, std::memory_order_relaxed);
+    Slot& slot = slots[sequence & mask];
+    
+    event.sequence = sequence;
+    
+    // Claim the slot by moving its stamp to odd (being written). A producer
+    // from an earlier lap still writing holds it odd; one from a later lap
+    // has already replaced this event, which readers would skip anyway.
+    uint64_t writing = 2 * sequence + 1;
+    uint64_t stamp = slot.stamp.load(std::memory_order_relaxed);
+    while (true) {
+        if (stamp > writing) {
+            return;
+        }
+        if (stamp & 1) {
+            std::this_thread::yield();
+            stamp = slot.stamp.load(std::memory_order_relaxed);
+            continue;
+        }
+        if (slot.stamp.compare_exchange_weak(stamp, writing, std::memory_order_relaxed)) {
+            break;
+        }
+    }
+    
+    std::atomic_thread_fence(std::memory_order_release);
+    std::memcpy(&slot.event, &event, sizeof(BookingEvent));
+    slot.stamp.store(2 * sequence + 2, std::memory_order_release);
+    
+    // Pairs with the increment in waitForEvent: either the consumer sees
+    // the stamp or this sees the consumer
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (idleConsumers.load(std::memory_order_relaxed) > 0) {
+        std::lock_guard<std::mutex> lock(idleMutex);
+        idleCv.notify_all();
+    }
+}
+
+uint64_t EventBus::getHeadSequence() const {
+    return nextSequence.load(std::memory_order_acquire);
+}
+
+bool EventBus::poll(uint64_t& cursor, BookingEvent& event, uint64_t& lost) const {
+    while (true) {
+        const Slot& slot = slots[cursor & mask];
+        uint64_t expected = 2 * cursor + 2;
+        
+        uint64_t before = slot.stamp.load(std::memory_order_acquire);
+        if (before < expected) {
+            return false; // Not published yet, or its producer is mid-write
+        }
+        
+        if (before == expected) {
+            std::memcpy(&event, &slot.event, sizeof(BookingEvent));
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (slot.stamp.load(std::memory_order_relaxed) == before) {
+                cursor++;
+                return true;
+            }
+        }
+        
+        // Overwritten by a later lap: skip to the oldest event still in the ring
+        uint64_t head = nextSequence.load(std::memory_order_acquire);
+        uint64_t oldest = head > capacity ? head - capacity + 1 : 0;
+        if (oldest <= cursor) {
+            oldest = cursor + 1;
+        }
+        lost += oldest - cursor;
+        cursor = oldest;
+    }
+}
+
+bool EventBus::hasEvent(uint64_t cursor) const {
+    // Published at the cursor, or lapped so poll has to skip ahead
+    return slots[cursor & mask].stamp.load(std::memory_order_acquire) >= 2 * cursor + 2;
+}
+
+void EventBus::waitForEvent(uint64_t cursor) {
+    idleConsumers.fetch_add(1, std::memory_order_seq_cst);
+    {
+        std::unique_lock<std::mutex> lock(idleMutex);
+        idleCv.wait_for(lock, std::chrono::milliseconds(100), [this, cursor]() {
+            return stopping.load() || hasEvent(cursor);
+        });
+    }
+    idleConsumers.fetch_sub(1, std::memory_order_relaxed);
+}
+
+void EventBus::subscribe(const std::string& name, Handler handler, LostHandler onLost) {
+    std::unique_ptr<Subscription> subscription(new Subscription());
+    subscription->name = name;
+    subscription->handler = handler;
+    subscription->onLost = onLost;
+    subscription->lost = 0;
+    
+    // Start from the head as of now, not whenever the thread gets scheduled
+    uint64_t cursor = getHeadSequence();
+    
+    Subscription* raw = subscription.get();
+    std::lock_guard<std::mutex> lock(subscriptionMutex);
+    subscriptions.push_back(std::move(subscription));
+    raw->worker = std::thread(&EventBus::runSubscription, this, raw, cursor);
+}
+
+void EventBus::runSubscription(Subscription* subscription, uint64_t cursor) {
+    uint64_t reportedLost = 0;
+    uint64_t lost = 0;
+    int idleRounds = 0;
+    BookingEvent event;
+    
+    while (!stopping) {
+        bool received = poll(cursor, event, lost);
+        
+        if (lost != reportedLost) {
+            std::cerr << "Event consumer " << subscription->name << " fell behind, "
+                      << (lost - reportedLost) << " event(s) lost" << std::endl;
+            subscription->lost.store(lost, std::memory_order_relaxed);
+            if (subscription->onLost) {
+                subscription->onLost(lost - reportedLost);
+            }
+            reportedLost = lost;
+        }
+        
+        if (received) {
+            idleRounds = 0;
+            try {
+                subscription->handler(event);
+            } catch (const std::exception& e) {
+                std::cerr << "Event consumer " << subscription->name 
+                          << " failed: " << e.what() << std::endl;
+            }
+            continue;
+        }
+        
+        // Spin briefly through bursts, then sleep until a producer signals
+        if (++idleRounds < 64) {
+            std::this_thread::yield();
+        } else {
+            waitForEvent(cursor);
+        }
+    }
+}
+
+uint64_t EventBus::getLostCount(const std::string& name) {
+    std::lock_guard<std::mutex> lock(subscriptionMutex);
+    for (const auto& subscription : subscriptions) {
+        if (subscription->name == name) {
+            return subscription->lost.load(std::memory_order_relaxed);
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,183 @@
+#include "utils/FareTable.h"
+#include "utils/DataStore.h"
+#include "utils/Config.h"
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+
+namespace {
+
+// Upper bound of each band in km, and the distance its fares are scaled to
+const int BAND_LIMIT_KM[FareTable::DISTANCE_BAND_COUNT] = {200, 500, 1000, 1500, 2500, 1000000};
+const int BAND_TYPICAL_KM[FareTable::DISTANCE_BAND_COUNT] = {100, 350, 750, 1250, 2000, 3000};
+
+// Tatkal charge as a share of the base fare with per-class floor and cap.
+// First AC has no tatkal quota.
+struct TatkalRule {
+    double rate;
+    double minimum;
+    double maximum;
+};
+
+const TatkalRule TATKAL_RULES[TRAVEL_CLASS_COUNT] = {
+    {0.0, 0.0, 0.0},        // 1A
+    {0.3, 400.0, 500.0},    // 2A
+    {0.3, 300.0, 400.0},    // 3A
+    {0.3, 300.0, 400.0},    // 3E
+    {0.3, 100.0, 200.0},    // SL
+    {0.3, 125.0, 225.0},    // CC
+    {0.3, 400.0, 500.0},    // EC
+    {0.1, 10.0, 15.0}       // 2S
+};
+
+}
+
+FareTable::FareTable() {
+    buildConcessions();
+    buildSurge();
+}
+
+FareTable* FareTable::getInstance() {
+    static FareTable instance;
+    return &instance;
+}
+
+size_t FareTable::indexOf(int fareRow, TravelClass travelClass, int band, Quota quota) {
+    return ((static_cast<size_t>(fareRow) * TRAVEL_CLASS_COUNT + static_cast<size_t>(travelClass))
+            * DISTANCE_BAND_COUNT + band) * QUOTA_COUNT + static_cast<size_t>(quota);
+}
+
+int FareTable::estimateDistanceKm(int durationMinutes) {
+    // Timetables carry no distances; assume a 55 km/h average including halts
+    return durationMinutes > 0 ? durationMinutes * 55 / 60 : 0;
+}
+
+int FareTable::distanceBand(int distanceKm) {
+    int band = 0;
+    while (band < DISTANCE_BAND_COUNT - 1 && distanceKm > BAND_LIMIT_KM[band]) {
+        band++;
+    }
+    return band;
+}
+
+double FareTable::tatkalFare(TravelClass travelClass, double baseFare) {
+    const TatkalRule& rule = TATKAL_RULES[static_cast<int>(travelClass)];
+    if (rule.rate <= 0.0) {
+        return -1.0;
+    }
+    double charge = std::min(std::max(baseFare * rule.rate, rule.minimum), rule.maximum);
+    return baseFare + charge;
+}
+
+void FareTable::buildConcessions() {
+    for (int quota = 0; quota < QUOTA_COUNT; quota++) {
+        for (int age = 0; age <= MAX_AGE; age++) {
+            double multiplier = 1.0;
+            if (age < 5) {
+                multiplier = 0.0;       // Infants travel free
+            } else if (quota != static_cast<int>(Quota::Tatkal)) {
+                if (age < 12) {
+                    multiplier = 0.5;   // Child fare
+                } else if (age >= 60) {
+                    multiplier = 0.6;   // Senior citizen concession
+                }
+            }
+            concessions[quota][age] = multiplier;
+        }
+    }
+}
+
+void FareTable::buildSurge() {
+    Config* config = Config::getInstance();
+    bool enabled = config->getBool("/fares/surgeEnabled", false);
+    double maxMultiplier = config->getDouble("/fares/maxSurgeMultiplier", 1.5);
+    
+    // Flat up to half sold, then rising linearly to the cap when full
+    for (int bucket = 0; bucket < SURGE_BUCKET_COUNT; bucket++) {
+        double multiplier = 1.0;
+        if (enabled && bucket > 5) {
+            multiplier += (maxMultiplier - 1.0) * (bucket - 5) / 5.0;
+        }
+        surgeMultipliers[bucket] = multiplier;
+    }
+}
+
+void FareTable::build() {
+    std::vector<Train*> rows;
+    DataStore::getInstance()->forEachTrain([&rows](Train& train) {
+        train.setFareRow(static_cast<int>(rows.size()));
+        rows.push_back(&train);
+    });
+    
+    baseFares.assign(rows.size() * TRAVEL_CLASS_COUNT * DISTANCE_BAND_COUNT * QUOTA_COUNT, -1.0);
+    trainBands.assign(rows.size(), 0);
+    
+    for (size_t row = 0; row < rows.size(); row++) {
+        const Train* train = rows[row];
+        int ownBand = distanceBand(estimateDistanceKm(train->getDurationMinutes()));
+        trainBands[row] = static_cast<uint8_t>(ownBand);
+        
+        for (const auto& avail : train->getAvailabilityRef()) {
+            TravelClass travelClass;
+            if (!parseTravelClass(avail.classCode, travelClass)) {
+                std::cerr << "No fares for unknown class " << avail.classCode 
+                          << " on " << train->getTrainNumber() << std::endl;
+                continue;
+            }
+            
+            // The stored price is the fare for the train's own band
+            for (int band = 0; band < DISTANCE_BAND_COUNT; band++) {
+                double general = std::round(avail.price * BAND_TYPICAL_KM[band] / BAND_TYPICAL_KM[ownBand]);
+                int fareRow = static_cast<int>(row);
+                
+                baseFares[indexOf(fareRow, travelClass, band, Quota::General)] = general;
+                baseFares[indexOf(fareRow, travelClass, band, Quota::Ladies)] = general;
+                baseFares[indexOf(fareRow, travelClass, band, Quota::Senior)] = general;
+                baseFares[indexOf(fareRow, travelClass, band, Quota::Tatkal)] = 
+                    std::round(tatkalFare(travelClass, general));
+            }
+        }
+    }
+    
+    std::cout << "Fare table built for " << rows.size() << " trains" << std::endl;
+}
+
+int FareTable::surgeBucket(const InventoryCounter* counter) {
+    if (!counter || counter->totalSeats <= 0) {
+        return 0;
+    }
+    
+    int available = 0;
+    for (int i = 0; i < QUOTA_COUNT; i++) {
+        available += counter->quotaSeats[i].load(std::memory_order_relaxed);
+    }
+    
+    int sold = counter->totalSeats - available;
+    int bucket = sold * 10 / counter->totalSeats;
+    return std::min(std::max(bucket, 0), SURGE_BUCKET_COUNT - 1);
+}
+
+double FareTable::baseFare(int fareRow, TravelClass travelClass, int band, Quota quota) const {
+    if (fareRow < 0 || static_cast<size_t>(fareRow) >= trainBands.size() ||
+        band < 0 || band >= DISTANCE_BAND_COUNT) {
+        return -1.0;
+    }
+    return baseFares[indexOf(fareRow, travelClass, band, quota)];
+}
+
+double FareTable::baseFare(const Train& train, TravelClass travelClass, Quota quota) const {
+    int fareRow = train.getFareRow();
+    if (fareRow < 0 || static_cast<size_t>(fareRow) >= trainBands.size()) {
+        return -1.0;
+    }
+    return baseFare(fareRow, travelClass, trainBands[fareRow], quota);
+}
+
+double FareTable::surgeMultiplier(int surgeBucket) const {
+    return surgeMultipliers[std::min(std::max(surgeBucket, 0), SURGE_BUCKET_COUNT - 1)];
+}
+
+double FareTable::passengerFare(double baseFare, Quota quota, int age, int surgeBucket) const {
+    age = std::min(std::max(age, 0), MAX_AGE);
+    return std::round(baseFare * concessions[static_cast<int>(quota)][age] * surgeMultiplier(surgeBucket));
+}
@@ -1,6 +1,9 @@
 #include "utils/HTTPServer.h"
+#include "utils/WaitingRoom.h"
+#include "utils/IdempotencyStore.h"
 #include <iostream>
 #include <sstream>
+#include <algorithm>
 
 HTTPServer::HTTPServer(int port, const std::string& host) 
     : port(port), host(host), router(nullptr), running(false) {
@@ -20,7 +23,7 @@ void HTTPServer::setupCORS() {
     server.Options(R"(.*)", [](const httplib::Request&, httplib::Response& res) {
         res.set_header("Access-Control-Allow-Origin", "*");
         res.set_header("Access-Control-Allow-Methods", "GET, POST, PUT, DELETE, OPTIONS");
-        res.set_header("Access-Control-Allow-Headers", "Content-Type, Authorization");
+        res.set_header("Access-Control-Allow-Headers", "Content-Type, Authorization, X-Queue-Token, Idempotency-Key, X-Finance-Key");
         res.set_header("Access-Control-Max-Age", "86400");
         res.status = 204;
     });
@@ -51,6 +54,92 @@ Request HTTPServer::parseHttplibRequest(const httplib::Request& req) {
     return request;
 }
 
+bool HTTPServer::admitFromWaitingRoom(const httplib::Request& req, httplib::Response& res,
+                                      uint64_t& queueTicket) {
+    queueTicket = 0;
+    WaitingRoom* room = WaitingRoom::getInstance();
+    if (!room->guards(req.method, req.path)) {
+        return true;
+    }
+    
+    uint64_t position = 0;
+    uint64_t number = 0;
+    if (room->isAdmitted(req.get_header_value("X-Queue-Token"), position, number)) {
+        queueTicket = number;
+        return true;
+    }
+    
+    nlohmann::json body = {
+        {"status", "error"},
+        {"message", position > 0 ? "You are in the waiting room" 
+                                 : "A valid X-Queue-Token is required, join via POST /api/queue/join"},
+        {"position", position},
+        {"estimatedWaitSeconds", room->estimateWaitSeconds(position)}
+    };
+    
+    res.status = 429;
+    res.set_header("Retry-After", std::to_string(std::max(1, room->estimateWaitSeconds(position))));
+    res.set_content(body.dump(), "application/json");
+    return false;
+}
+
+bool HTTPServer::spendQueueTicket(const httplib::Request& req, httplib::Response& res,
+                                  uint64_t queueTicket) {
+    if (queueTicket == 0 || WaitingRoom::getInstance()->spend(req.path, queueTicket)) {
+        return true;
+    }
+    
+    res.status = 429;
+    res.set_content("{\"status\":\"error\",\"message\":\"This X-Queue-Token was already used, join via POST /api/queue/join\"}", "application/json");
+    return false;
+}
+
+bool HTTPServer::beginIdempotentRequest(const httplib::Request& req, httplib::Response& res,
+                                        std::string& storeKey) {
+    storeKey.clear();
+    
+    std::string key = req.get_header_value("Idempotency-Key");
+    std::string authorization = req.get_header_value("Authorization");
+    if (req.path != "/api/bookings" || key.empty() || authorization.empty()) {
+        return true;
+    }
+    
+    if (key.size() > 255) {
+        res.status = 400;
+        res.set_content("{\"status\":\"error\",\"message\":\"Idempotency-Key must be at most 255 characters\"}", "application/json");
+        return false;
+    }
+    
+    // Scope keys to the caller so one user cannot replay another's booking
+    std::string scopedKey = authorization + "|" + key;
+    
+    StoredResponse stored;
+    switch (IdempotencyStore::getInstance()->begin(scopedKey, req.body, stored)) {
+        case IdempotencyState::Started:
+            storeKey = scopedKey;
+            return true;
+        case IdempotencyState::Replay:
+            res.status = stored.statusCode;
+            res.set_header("Idempotent-Replayed", "true");
+            res.set_content(stored.body, "application/json");
+            return false;
+        case IdempotencyState::InFlight:
+            res.status = 409;
+            res.set_content("{\"status\":\"error\",\"message\":\"A request with this Idempotency-Key is still in progress\"}", "application/json");
+            return false;
+        case IdempotencyState::Full:
+            res.status = 503;
+            res.set_header("Retry-After", "1");
+            res.set_content("{\"status\":\"error\",\"message\":\"Too many bookings in progress, please retry\"}", "application/json");
+            return false;
+        case IdempotencyState::Mismatch:
+        default:
+            res.status = 422;
+            res.set_content("{\"status\":\"error\",\"message\":\"Idempotency-Key was already used with a different request\"}", "application/json");
+            return false;
+    }
+}
+
 void HTTPServer::start() {
     if (!router) {
         std::cerr << "Error: Router not set!" << std::endl;
@@ -66,7 +155,7 @@ void HTTPServer::start() {
     auto addCORSHeaders = [](httplib::Response& res) {
         res.set_header("Access-Control-Allow-Origin", "*");
         res.set_header("Access-Control-Allow-Methods", "GET, POST, PUT, DELETE, OPTIONS");
-        res.set_header("Access-Control-Allow-Headers", "Content-Type, Authorization");
+        res.set_header("Access-Control-Allow-Headers", "Content-Type, Authorization, X-Queue-Token, Idempotency-Key, X-Finance-Key");
     };
     
     // Handle all requests
@@ -77,6 +166,11 @@ void HTTPServer::start() {
             Response response = router->route(request);
             
             res.status = response.statusCode;
+            for (const auto& header : response.headers) {
+                if (header.first != "Content-Type") { // Set by set_content
+                    res.set_header(header.first.c_str(), header.second);
+                }
+            }
             res.set_content(response.toString(), "application/json");
             addCORSHeaders(res);
         } catch (const std::exception& e) {
@@ -88,16 +182,66 @@ void HTTPServer::start() {
     });
     
     server.Post(R"(.*)", [this, addCORSHeaders](const httplib::Request& req, httplib::Response& res) {
+        std::string idempotencyKey;
+        uint64_t queueTicket = 0;
+        bool ticketSpent = false;
         try {
             std::cout << "POST " << req.path << std::endl;
+            
+            // Turn away unadmitted booking traffic before parsing the body
+            if (!admitFromWaitingRoom(req, res, queueTicket)) {
+                addCORSHeaders(res);
+                return;
+            }
+            
+            // Retried bookings get the first response back without running again
+            if (!beginIdempotentRequest(req, res, idempotencyKey)) {
+                addCORSHeaders(res);
+                return;
+            }
+            
+            // Replays are served above; anything that runs uses up the ticket
+            if (!spendQueueTicket(req, res, queueTicket)) {
+                if (!idempotencyKey.empty()) {
+                    IdempotencyStore::getInstance()->abandon(idempotencyKey);
+                }
+                addCORSHeaders(res);
+                return;
+            }
+            ticketSpent = queueTicket != 0;
+            
             Request request = parseHttplibRequest(req);
             Response response = router->route(request);
             
             res.status = response.statusCode;
+            for (const auto& header : response.headers) {
+                if (header.first != "Content-Type") { // Set by set_content
+                    res.set_header(header.first.c_str(), header.second);
+                }
+            }
             res.set_content(response.toString(), "application/json");
             addCORSHeaders(res);
+            
+            if (!idempotencyKey.empty()) {
+                IdempotencyStore* idempotency = IdempotencyStore::getInstance();
+                // Rejected requests changed nothing; a corrected retry runs again
+                if (res.status >= 400) {
+                    idempotency->abandon(idempotencyKey);
+                } else {
+                    idempotency->complete(idempotencyKey, res.status, res.body);
+                }
+            }
+            if (ticketSpent && res.status >= 400) {
+                WaitingRoom::getInstance()->restore(req.path, queueTicket);
+            }
         } catch (const std::exception& e) {
             std::cerr << "Error handling POST request: " << e.what() << std::endl;
+            if (!idempotencyKey.empty()) {
+                IdempotencyStore::getInstance()->abandon(idempotencyKey);
+            }
+            if (ticketSpent) {
+                WaitingRoom::getInstance()->restore(req.path, queueTicket);
+            }
             res.status = 500;
             res.set_content("{\"status\":\"error\",\"message\":\"Internal server error\"}", "application/json");
             addCORSHeaders(res);
@@ -111,6 +255,11 @@ void HTTPServer::start() {
             Response response = router->route(request);
             
             res.status = response.statusCode;
+            for (const auto& header : response.headers) {
+                if (header.first != "Content-Type") { // Set by set_content
+                    res.set_header(header.first.c_str(), header.second);
+                }
+            }
             res.set_content(response.toString(), "application/json");
             addCORSHeaders(res);
         } catch (const std::exception& e) {
@@ -128,6 +277,11 @@ void HTTPServer::start() {
             Response response = router->route(request);
             
             res.status = response.statusCode;
+            for (const auto& header : response.headers) {
+                if (header.first != "Content-Type") { // Set by set_content
+                    res.set_header(header.first.c_str(), header.second);
+                }
+            }
             res.set_content(response.toString(), "application/json");
             addCORSHeaders(res);
         } catch (const std::exception& e) {
@@ -0,0 +1,99 @@
+#include "utils/IdempotencyStore.h"
+#include "utils/Config.h"
+#include <functional>
+
+IdempotencyStore::IdempotencyStore() {
+    Config* config = Config::getInstance();
+    int ttlSeconds = config->getInt("/idempotency/ttlSeconds", 86400);
+    int maxEntries = config->getInt("/idempotency/maxEntries", 100000);
+    
+    ttl = std::chrono::seconds(ttlSeconds > 0 ? ttlSeconds : 86400);
+    maxEntriesPerShard = static_cast<size_t>(maxEntries > SHARD_COUNT ? maxEntries : SHARD_COUNT) / SHARD_COUNT;
+}
+
+IdempotencyStore* IdempotencyStore::getInstance() {
+    static IdempotencyStore instance;
+    return &instance;
+}
+
+IdempotencyStore::Shard& IdempotencyStore::shardFor(const std::string& key) {
+    return shards[std::hash<std::string>()(key) % SHARD_COUNT];
+}
+
+void IdempotencyStore::evictLocked(Shard& shard, std::chrono::steady_clock::time_point now) {
+    while (!shard.order.empty()) {
+        const auto& oldest = shard.order.front();
+        bool expired = now - oldest.second >= ttl;
+        if (!expired && shard.entries.size() < maxEntriesPerShard) {
+            break;
+        }
+        
+        // Skip queue records left behind by abandoned keys that were reused
+        auto it = shard.entries.find(oldest.first);
+        if (it != shard.entries.end() && it->second.createdAt == oldest.second) {
+            if (!expired && !it->second.completed) {
+                break;
+            }
+            shard.entries.erase(it);
+        }
+        shard.order.pop_front();
+    }
+}
+
+IdempotencyState IdempotencyStore::begin(const std::string& key, const std::string& requestBody,
+                                         StoredResponse& stored) {
+    Shard& shard = shardFor(key);
+    auto now = std::chrono::steady_clock::now();
+    size_t requestHash = std::hash<std::string>()(requestBody);
+    
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    evictLocked(shard, now);
+    
+    auto it = shard.entries.find(key);
+    if (it != shard.entries.end()) {
+        if (it->second.requestHash != requestHash) {
+            return IdempotencyState::Mismatch;
+        }
+        if (!it->second.completed) {
+            return IdempotencyState::InFlight;
+        }
+        stored = it->second.response;
+        return IdempotencyState::Replay;
+    }
+    
+    if (shard.entries.size() >= maxEntriesPerShard) {
+        return IdempotencyState::Full;
+    }
+    
+    Entry entry;
+    entry.completed = false;
+    entry.requestHash = requestHash;
+    entry.response = {0, ""};
+    entry.createdAt = now;
+    
+    shard.entries.emplace(key, std::move(entry));
+    shard.order.emplace_back(key, now);
+    return IdempotencyState::Started;
+}
+
+void IdempotencyStore::complete(const std::string& key, int statusCode, const std::string& body) {
+    Shard& shard = shardFor(key);
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    
+    auto it = shard.entries.find(key);
+    if (it != shard.entries.end()) {
+        it->second.completed = true;
+        it->second.response = {statusCode, body};
+    }
+}
+
+void IdempotencyStore::abandon(const std::string& key) {
+    Shard& shard = shardFor(key);
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    
+    // The order record stays behind and is skipped when it reaches the front
+    auto it = shard.entries.find(key);
+    if (it != shard.entries.end() && !it->second.completed) {
+        shard.entries.erase(it);
+    }
+}
@@ -0,0 +1,216 @@
+#include "utils/Ledger.h"
+#include "utils/Config.h"
+#include "utils/DateUtils.h"
+#include "utils/Scheduler.h"
+#include <chrono>
+#include <cstring>
+#include <iostream>
+
+namespace {
+
+template <size_t N>
+void copyField(char (&field)[N], const std::string& value) {
+    size_t length = value.size() < N - 1 ? value.size() : N - 1;
+    std::memcpy(field, value.data(), length);
+    field[length] = '\0';
+}
+
+// Finance days are the railway's local days, like journey dates
+std::string entryDay(const LedgerEntry& entry) {
+    return DateUtils::formatDate(Scheduler::getInstance()->localDay(
+        static_cast<std::time_t>(entry.timestampMs / 1000)));
+}
+
+}
+
+nlohmann::json LedgerEntry::toJson() const {
+    return {
+        {"timestamp", timestampMs},
+        {"type", type == LedgerEntryType::Fare ? "fare" : "refund"},
+        {"bookingId", bookingId},
+        {"userId", userId},
+        {"trainNumber", trainNumber},
+        {"amount", amount}
+    };
+}
+
+LedgerTotals::LedgerTotals() : fares(0.0), refunds(0.0), fareEntries(0), refundEntries(0) {}
+
+void LedgerTotals::add(const LedgerEntry& entry) {
+    if (entry.type == LedgerEntryType::Fare) {
+        fares += entry.amount;
+        fareEntries++;
+    } else {
+        refunds += entry.amount;
+        refundEntries++;
+    }
+}
+
+nlohmann::json LedgerTotals::toJson() const {
+    return {
+        {"fares", fares},
+        {"refunds", refunds},
+        {"net", fares - refunds},
+        {"fareEntries", fareEntries},
+        {"refundEntries", refundEntries}
+    };
+}
+
+Ledger::ThreadBuffer::ThreadBuffer() : head(0), tail(0) {}
+
+Ledger::Ledger() : stopping(false) {
+    // Created first so it outlives the final aggregate in the destructor
+    Scheduler::getInstance();
+    
+    Config* config = Config::getInstance();
+    intervalMs = config->getInt("/ledger/aggregationIntervalMs", 1000);
+    if (intervalMs < 10) intervalMs = 10;
+    
+    if (config->getBool("/storage/persistToFile", false)) {
+        std::string path = config->getString("/storage/dataDirectory", "./data") + "/ledger.jsonl";
+        journalFile.open(path, std::ios::app);
+        if (!journalFile.is_open()) {
+            std::cerr << "Could not open ledger journal " << path << std::endl;
+        }
+    }
+    
+    aggregator = std::thread(&Ledger::runAggregator, this);
+}
+
+Ledger::~Ledger() {
+    {
+        std::lock_guard<std::mutex> lock(aggregatorWaitMutex);
+        stopping = true;
+    }
+    aggregatorCv.notify_all();
+    if (aggregator.joinable()) {
+        aggregator.join();
+    }
+    aggregate();
+}
+
+Ledger* Ledger::getInstance() {
+    static Ledger instance;
+    return &instance;
+}
+
+Ledger::ThreadBuffer* Ledger::localBuffer() {
+    // Registered once per thread; the ledger owns it so entries outlive the thread
+    thread_local ThreadBuffer* buffer = nullptr;
+    if (!buffer) {
+        std::unique_ptr<ThreadBuffer> created(new ThreadBuffer());
+        buffer = created.get();
+        std::lock_guard<std::mutex> lock(registryMutex);
+        buffers.push_back(std::move(created));
+    }
+    return buffer;
+}
+
+void Ledger::record(LedgerEntryType type, const Booking& booking, double amount) {
+    LedgerEntry entry;
+    std::memset(&entry, 0, sizeof(entry));
+    entry.timestampMs = std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+    entry.type = type;
+    copyField(entry.bookingId, booking.getBookingId());
+    copyField(entry.userId, booking.getUserId());
+    copyField(entry.trainNumber, booking.getTrain().getTrainNumber());
+    entry.amount = amount;
+    
+    ThreadBuffer* buffer = localBuffer();
+    size_t head = buffer->head.load(std::memory_order_relaxed);
+    size_t tail = buffer->tail.load(std::memory_order_acquire);
+    
+    if (head - tail == BUFFER_CAPACITY) {
+        std::lock_guard<std::mutex> lock(overflowMutex);
+        overflow.push_back(entry);
+        return;
+    }
+    
+    buffer->entries[head % BUFFER_CAPACITY] = entry;
+    buffer->head.store(head + 1, std::memory_order_release);
+}
+
+void Ledger::aggregate() {
+    std::lock_guard<std::mutex> aggregateLock(aggregateMutex);
+    std::vector<LedgerEntry> batch;
+    
+    {
+        std::lock_guard<std::mutex> lock(registryMutex);
+        for (auto& buffer : buffers) {
+            size_t tail = buffer->tail.load(std::memory_order_relaxed);
+            size_t head = buffer->head.load(std::memory_order_acquire);
+            for (size_t i = tail; i < head; i++) {
+                batch.push_back(buffer->entries[i % BUFFER_CAPACITY]);
+            }
+            buffer->tail.store(head, std::memory_order_release);
+        }
+    }
+    
+    {
+        std::lock_guard<std::mutex> lock(overflowMutex);
+        batch.insert(batch.end(), overflow.begin(), overflow.end());
+        overflow.clear();
+    }
+    
+    if (batch.empty()) {
+        return;
+    }
+    
+    if (journalFile.is_open()) {
+        for (const auto& entry : batch) {
+            journalFile << entry.toJson().dump() << "\n";
+        }
+        journalFile.flush();
+    }
+    
+    // One writer lock per batch, not per entry
+    std::unique_lock<std::shared_mutex> lock(totalsMutex);
+    for (const auto& entry : batch) {
+        overall.add(entry);
+        byTrain[entry.trainNumber].add(entry);
+        byDay[entryDay(entry)].add(entry);
+        byUser[entry.userId].add(entry);
+    }
+}
+
+void Ledger::runAggregator() {
+    std::unique_lock<std::mutex> lock(aggregatorWaitMutex);
+    while (!stopping) {
+        aggregatorCv.wait_for(lock, std::chrono::milliseconds(intervalMs));
+        if (stopping) break;
+        
+        lock.unlock();
+        aggregate();
+        lock.lock();
+    }
+}
+
+LedgerTotals Ledger::getOverallTotals() const {
+    std::shared_lock<std::shared_mutex> lock(totalsMutex);
+    return overall;
+}
+
+bool Ledger::getTrainTotals(const std::string& trainNumber, LedgerTotals& totals) const {
+    std::shared_lock<std::shared_mutex> lock(totalsMutex);
+    auto it = byTrain.find(trainNumber);
+    if (it == byTrain.end()) return false;
+    totals = it->second;
+    return true;
+}
+
+bool Ledger::getDayTotals(const std::string& date, LedgerTotals& totals) const {
+    std::shared_lock<std::shared_mutex> lock(totalsMutex);
+    auto it = byDay.find(date);
+    if (it == byDay.end()) return false;
+    totals = it->second;
+    return true;
+}
+
+bool Ledger::getUserTotals(const std::string& userId, LedgerTotals& totals) const {
+    std::shared_lock<std::shared_mutex> lock(totalsMutex);
+    auto it = byUser.find(userId);
+    if (it == byUser.end()) return false;
+    totals = it->second;
+    return true;
+}
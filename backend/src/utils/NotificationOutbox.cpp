@@ -0,0 +1,350 @@
+#include "utils/NotificationOutbox.h"
+#include "utils/Config.h"
+#include "utils/DataStore.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <iostream>
+#include <map>
+
+namespace {
+
+const char* typeName(NotificationType type) {
+    switch (type) {
+        case NotificationType::BookingCancelled: return "BookingCancelled";
+        case NotificationType::PassengersCancelled: return "PassengersCancelled";
+        default: return "BookingConfirmed";
+    }
+}
+
+bool parseType(const std::string& name, NotificationType& type) {
+    if (name == "BookingConfirmed") type = NotificationType::BookingConfirmed;
+    else if (name == "BookingCancelled") type = NotificationType::BookingCancelled;
+    else if (name == "PassengersCancelled") type = NotificationType::PassengersCancelled;
+    else return false;
+    return true;
+}
+
+std::string formatAmount(double amount) {
+    char buffer[32];
+    std::snprintf(buffer, sizeof(buffer), "Rs %.2f", amount);
+    return std::string(buffer);
+}
+
+std::string passengerStatus(const Passenger& passenger, const std::string& bookingStatus) {
+    if (passenger.isCancelled() || bookingStatus == "Cancelled") {
+        return "CAN";
+    }
+    if (bookingStatus != "Confirmed") {
+        return passenger.getAssignedSeat(); // "RAC n" or "WL n"
+    }
+    std::string status = "CNF " + passenger.getAssignedSeat();
+    if (!passenger.getAssignedBerth().empty()) {
+        status += " " + passenger.getAssignedBerth();
+    }
+    return status;
+}
+
+}
+
+nlohmann::json Notification::toJson() const {
+    return {
+        {"id", id},
+        {"type", typeName(type)},
+        {"createdAt", createdMs},
+        {"bookingId", bookingId},
+        {"pnr", pnr},
+        {"userId", userId},
+        {"trainNumber", trainNumber},
+        {"journeyDate", journeyDate},
+        {"class", classCode},
+        {"status", status},
+        {"totalFare", totalFare},
+        {"refundAmount", refundAmount},
+        {"passengers", passengerStatuses}
+    };
+}
+
+bool Notification::fromJson(const nlohmann::json& json, Notification& notification) {
+    try {
+        if (!parseType(json.at("type").get<std::string>(), notification.type)) {
+            return false;
+        }
+        notification.id = json.at("id").get<uint64_t>();
+        notification.createdMs = json.at("createdAt").get<int64_t>();
+        notification.bookingId = json.at("bookingId").get<std::string>();
+        notification.pnr = json.at("pnr").get<std::string>();
+        notification.userId = json.at("userId").get<std::string>();
+        notification.trainNumber = json.at("trainNumber").get<std::string>();
+        notification.journeyDate = json.at("journeyDate").get<std::string>();
+        notification.classCode = json.at("class").get<std::string>();
+        notification.status = json.at("status").get<std::string>();
+        notification.totalFare = json.at("totalFare").get<double>();
+        notification.refundAmount = json.at("refundAmount").get<double>();
+        notification.passengerStatuses = json.at("passengers").get<std::vector<std::string>>();
+    } catch (const std::exception&) {
+        return false;
+    }
+    return true;
+}
+
+NotificationOutbox::NotificationOutbox() : nextId(1), deliveredCount(0), stopping(false) {
+    Config* config = Config::getInstance();
+    enabled = config->getBool("/notifications/enabled", true);
+    
+    int configuredBatch = config->getInt("/notifications/batchSize", 100);
+    batchSize = configuredBatch > 0 ? static_cast<size_t>(configuredBatch) : 1;
+    batchIntervalMs = std::max(10, config->getInt("/notifications/batchIntervalMs", 200));
+    maxRetryDelayMs = std::max(batchIntervalMs, config->getInt("/notifications/maxRetryDelayMs", 30000));
+    
+    if (config->getBool("/storage/persistToFile", false)) {
+        journalPath = config->getString("/storage/dataDirectory", "./data") + "/outbox.jsonl";
+    }
+}
+
+NotificationOutbox::~NotificationOutbox() {
+    {
+        std::lock_guard<std::mutex> lock(outboxMutex);
+        stopping = true;
+    }
+    dispatchCv.notify_all();
+    if (dispatcher.joinable()) {
+        dispatcher.join();
+    }
+}
+
+NotificationOutbox* NotificationOutbox::getInstance() {
+    static NotificationOutbox instance;
+    return &instance;
+}
+
+void NotificationOutbox::setSink(std::unique_ptr<NotificationSink> newSink) {
+    std::lock_guard<std::mutex> lock(outboxMutex);
+    sink = std::move(newSink);
+}
+
+void NotificationOutbox::replayJournal() {
+    std::ifstream in(journalPath);
+    if (!in.is_open()) {
+        return;
+    }
+    
+    // Records are delivered in id order, so one watermark covers them all
+    std::map<uint64_t, Notification> records;
+    uint64_t deliveredUpTo = 0;
+    std::string line;
+    while (std::getline(in, line)) {
+        nlohmann::json json = nlohmann::json::parse(line, nullptr, false);
+        if (json.is_discarded()) {
+            continue; // Torn last line after a crash
+        }
+        
+        if (json.contains("delivered")) {
+            deliveredUpTo = std::max(deliveredUpTo, json["delivered"].get<uint64_t>());
+            continue;
+        }
+        
+        Notification notification;
+        if (Notification::fromJson(json, notification)) {
+            records[notification.id] = notification;
+            nextId = std::max(nextId, notification.id + 1);
+        }
+    }
+    in.close();
+    
+    for (const auto& entry : records) {
+        if (entry.first > deliveredUpTo) {
+            pending.push_back(entry.second);
+        }
+    }
+    
+    // Compact to the undelivered records
+    std::string compactPath = journalPath + ".tmp";
+    {
+        std::ofstream out(compactPath, std::ios::trunc);
+        for (const auto& notification : pending) {
+            out << notification.toJson().dump() << "\n";
+        }
+    }
+    if (std::rename(compactPath.c_str(), journalPath.c_str()) != 0) {
+        std::cerr << "Could not compact notification outbox " << journalPath << std::endl;
+    }
+    
+    if (!pending.empty()) {
+        std::cout << "Notification outbox restored " << pending.size()
+                  << " undelivered record(s)" << std::endl;
+    }
+}
+
+void NotificationOutbox::start() {
+    if (!enabled) {
+        return;
+    }
+    
+    std::lock_guard<std::mutex> lock(outboxMutex);
+    if (dispatcher.joinable()) {
+        return;
+    }
+    
+    if (!journalPath.empty()) {
+        replayJournal();
+        journalFile.open(journalPath, std::ios::app);
+        if (!journalFile.is_open()) {
+            std::cerr << "Could not open notification outbox " << journalPath << std::endl;
+        }
+    }
+    
+    dispatcher = std::thread(&NotificationOutbox::runDispatcher, this);
+}
+
+void NotificationOutbox::enqueue(NotificationType type, const Booking& booking, double refundAmount) {
+    if (!enabled) {
+        return;
+    }
+    
+    Notification notification;
+    notification.type = type;
+    notification.createdMs = std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+    notification.bookingId = booking.getBookingId();
+    notification.pnr = booking.getPnr();
+    notification.userId = booking.getUserId();
+    notification.trainNumber = booking.getTrain().getTrainNumber();
+    notification.journeyDate = booking.getJourneyDate();
+    notification.classCode = booking.getClassCode();
+    notification.status = booking.getStatus();
+    notification.totalFare = booking.getTotalFare();
+    notification.refundAmount = refundAmount;
+    for (const auto& passenger : booking.getPassengers()) {
+        notification.passengerStatuses.push_back(passengerStatus(passenger, notification.status));
+    }
+    
+    std::lock_guard<std::mutex> lock(outboxMutex);
+    notification.id = nextId++;
+    
+    if (journalFile.is_open()) {
+        journalFile << notification.toJson().dump() << "\n";
+        journalFile.flush();
+    }
+    
+    pending.push_back(std::move(notification));
+    
+    // Otherwise the dispatcher picks it up on its next interval
+    if (pending.size() >= batchSize) {
+        dispatchCv.notify_one();
+    }
+}
+
+std::vector<NotificationMessage> NotificationOutbox::render(const std::vector<Notification>& batch) {
+    DataStore* store = DataStore::getInstance();
+    std::vector<NotificationMessage> messages;
+    messages.reserve(batch.size() * 2);
+    
+    for (const auto& notification : batch) {
+        std::string name, email, phone;
+        User* user = store->findUserById(notification.userId);
+        if (user) {
+            name = user->getName();
+            email = user->getEmail();
+            phone = user->getPhone();
+        }
+        
+        std::string trainName;
+        Train* train = store->findTrainByNumber(notification.trainNumber);
+        if (train) {
+            trainName = train->getTrainName();
+        }
+        
+        std::string journey = notification.trainNumber + " " + trainName + " on " +
+                              notification.journeyDate + " in " + notification.classCode;
+        
+        std::string subject, summary, amountLine;
+        switch (notification.type) {
+            case NotificationType::BookingConfirmed:
+                subject = "Booking confirmed - PNR " + notification.pnr;
+                summary = "PNR " + notification.pnr + " confirmed: " + journey + ".";
+                amountLine = "Fare " + formatAmount(notification.totalFare);
+                break;
+            case NotificationType::BookingCancelled:
+                subject = "Booking cancelled - PNR " + notification.pnr;
+                summary = "PNR " + notification.pnr + " cancelled: " + journey + ".";
+                amountLine = "Refund " + formatAmount(notification.refundAmount);
+                break;
+            case NotificationType::PassengersCancelled:
+                subject = "Passengers cancelled - PNR " + notification.pnr;
+                summary = "PNR " + notification.pnr + " updated: " + journey + ".";
+                amountLine = "Refund " + formatAmount(notification.refundAmount) +
+                             ", remaining fare " + formatAmount(notification.totalFare);
+                break;
+        }
+        
+        std::string smsPassengers, emailPassengers;
+        for (size_t i = 0; i < notification.passengerStatuses.size(); i++) {
+            std::string label = "P" + std::to_string(i + 1) + " " + notification.passengerStatuses[i];
+            smsPassengers += (i > 0 ? ", " : " ") + label;
+            emailPassengers += "  " + label + "\n";
+        }
+        
+        if (!phone.empty()) {
+            messages.push_back({notification.id, "sms", phone, "",
+                                summary + smsPassengers + ". " + amountLine});
+        }
+        if (!email.empty()) {
+            messages.push_back({notification.id, "email", email, subject,
+                                "Dear " + (name.empty() ? std::string("customer") : name) + ",\n\n" +
+                                summary + "\n\nPassengers:\n" + emailPassengers + "\n" + amountLine + "\n"});
+        }
+    }
+    
+    return messages;
+}
+
+void NotificationOutbox::runDispatcher() {
+    std::unique_lock<std::mutex> lock(outboxMutex);
+    int retryDelayMs = 0;
+    
+    while (!stopping) {
+        if (retryDelayMs > 0) {
+            dispatchCv.wait_for(lock, std::chrono::milliseconds(retryDelayMs),
+                                [this]() { return stopping; });
+        } else if (pending.size() < batchSize) {
+            dispatchCv.wait_for(lock, std::chrono::milliseconds(batchIntervalMs));
+        }
+        if (stopping) break;
+        if (pending.empty() || !sink) continue;
+        
+        // Only this thread removes records, so the front stays put while unlocked
+        size_t count = std::min(batchSize, pending.size());
+        std::vector<Notification> batch(pending.begin(), pending.begin() + count);
+        
+        lock.unlock();
+        std::vector<NotificationMessage> messages = render(batch);
+        bool delivered = messages.empty() || sink->deliver(messages);
+        lock.lock();
+        
+        if (!delivered) {
+            retryDelayMs = retryDelayMs == 0 ? batchIntervalMs : std::min(retryDelayMs * 2, maxRetryDelayMs);
+            std::cerr << "Notification sink failed, retrying " << count
+                      << " record(s) in " << retryDelayMs << " ms" << std::endl;
+            continue;
+        }
+        
+        retryDelayMs = 0;
+        pending.erase(pending.begin(), pending.begin() + count);
+        deliveredCount.fetch_add(count, std::memory_order_relaxed);
+        
+        if (journalFile.is_open()) {
+            journalFile << nlohmann::json{{"delivered", batch.back().id}}.dump() << "\n";
+            journalFile.flush();
+        }
+    }
+}
+
+size_t NotificationOutbox::getPendingCount() {
+    std::lock_guard<std::mutex> lock(outboxMutex);
+    return pending.size();
+}
+
+uint64_t NotificationOutbox::getDeliveredCount() const {
+    return deliveredCount.load(std::memory_order_relaxed);
+}
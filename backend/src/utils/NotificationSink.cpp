@@ -0,0 +1,43 @@
+#include "utils/NotificationSink.h"
+#include <iostream>
+
+nlohmann::json NotificationMessage::toJson() const {
+    return {
+        {"notificationId", notificationId},
+        {"channel", channel},
+        {"recipient", recipient},
+        {"subject", subject},
+        {"body", body}
+    };
+}
+
+FileNotificationSink::FileNotificationSink(const std::string& path) : path(path) {
+    file.open(path, std::ios::app);
+    if (!file.is_open()) {
+        std::cerr << "Could not open notification sink " << path << std::endl;
+    }
+}
+
+bool FileNotificationSink::deliver(const std::vector<NotificationMessage>& messages) {
+    std::lock_guard<std::mutex> lock(fileMutex);
+    
+    // The directory may appear after startup
+    if (!file.is_open()) {
+        file.clear();
+        file.open(path, std::ios::app);
+        if (!file.is_open()) {
+            return false;
+        }
+    }
+    
+    for (const auto& message : messages) {
+        file << message.toJson().dump() << "\n";
+    }
+    file.flush();
+    
+    if (!file.good()) {
+        file.close();
+        return false;
+    }
+    return true;
+}
@@ -0,0 +1,150 @@
+#include "utils/PnrCache.h"
+#include "utils/DataStore.h"
+#include <mutex>
+#include <iostream>
+
+PnrCache::PnrCache() {}
+
+PnrCache* PnrCache::getInstance() {
+    static PnrCache instance;
+    return &instance;
+}
+
+PnrCache::Shard& PnrCache::shardFor(uint64_t key) {
+    return shards[key % SHARD_COUNT];
+}
+
+bool PnrCache::encodePnr(const std::string& pnr, uint64_t& key) {
+    key = 0;
+    int digits = 0;
+    
+    for (size_t i = 0; i < pnr.size(); i++) {
+        char c = pnr[i];
+        if (c == '-' && i == 3) {
+            continue;
+        }
+        if (c < '0' || c > '9') {
+            return false;
+        }
+        key = key * 10 + static_cast<uint64_t>(c - '0');
+        digits++;
+    }
+    
+    return digits == 10;
+}
+
+std::string PnrCache::buildStatus(const BookingEvent& event) {
+    // Train details do not change after load, so resolve them once per event
+    std::string trainName, fromStation, toStation, departureTime;
+    Train* train = DataStore::getInstance()->findTrainByNumber(event.trainNumber);
+    if (train) {
+        trainName = train->getTrainName();
+        fromStation = train->getFromStation();
+        toStation = train->getToStation();
+        departureTime = train->getDepartureTime();
+    }
+    
+    std::string status = event.status;
+    nlohmann::json passengers = nlohmann::json::array();
+    for (uint8_t i = 0; i < event.passengerCount; i++) {
+        const BookingEvent::PassengerState& passenger = event.passengers[i];
+        
+        std::string current;
+        if (passenger.cancelled || status == "Cancelled") {
+            current = "CAN";
+        } else if (status == "Confirmed") {
+            current = "CNF " + std::string(passenger.seat);
+            if (passenger.berth[0] != '\0') {
+                current += " " + std::string(passenger.berth);
+            }
+        } else {
+            current = passenger.seat; // "RAC n" or "WL n"
+        }
+        
+        passengers.push_back({
+            {"number", i + 1},
+            {"currentStatus", current}
+        });
+    }
+    
+    nlohmann::json body = {
+        {"status", "success"},
+        {"data", {
+            {"pnr", event.pnr},
+            {"trainNumber", event.trainNumber},
+            {"trainName", trainName},
+            {"from", fromStation},
+            {"to", toStation},
+            {"departureTime", departureTime},
+            {"journeyDate", event.journeyDate},
+            {"class", event.classCode},
+            {"quota", event.quota},
+            {"bookingStatus", status},
+            {"passengers", passengers}
+        }}
+    };
+    
+    return body.dump();
+}
+
+void PnrCache::apply(const BookingEvent& event) {
+    if (event.type != BookingEventType::BookingCreated &&
+        event.type != BookingEventType::BookingUpdated &&
+        event.type != BookingEventType::BookingCancelled) {
+        return;
+    }
+    
+    uint64_t key;
+    if (!encodePnr(event.pnr, key)) {
+        return;
+    }
+    
+    std::string status = buildStatus(event);
+    
+    Shard& shard = shardFor(key);
+    std::unique_lock<std::shared_mutex> lock(shard.mutex);
+    shard.statuses[key] = std::move(status);
+}
+
+void PnrCache::rebuild() {
+    // Only after the consumer lost events: one pass over the store
+    std::vector<BookingEvent> snapshots;
+    DataStore::getInstance()->forEachBooking([&snapshots](const Booking& booking) {
+        snapshots.push_back(BookingEvent::forBooking(BookingEventType::BookingUpdated, booking));
+    });
+    
+    for (const auto& snapshot : snapshots) {
+        apply(snapshot);
+    }
+    
+    std::cout << "PNR cache rebuilt from " << snapshots.size() << " booking(s)" << std::endl;
+}
+
+void PnrCache::start() {
+    EventBus::getInstance()->subscribe(
+        "pnr-cache",
+        [this](const BookingEvent& event) { apply(event); },
+        [this](uint64_t) { rebuild(); }
+    );
+}
+
+bool PnrCache::lookup(uint64_t key, std::string& statusJson) {
+    Shard& shard = shardFor(key);
+    std::shared_lock<std::shared_mutex> lock(shard.mutex);
+    
+    auto it = shard.statuses.find(key);
+    if (it == shard.statuses.end()) {
+        return false;
+    }
+    statusJson = it->second;
+    return true;
+}
+
+size_t PnrCache::size() {
+    size_t total = 0;
+    for (auto& shard : shards) {
+        std::shared_lock<std::shared_mutex> lock(shard.mutex);
+        total += shard.statuses.size();
+    }
+    return total;
+}
@@ -28,7 +28,14 @@ void Response::setSuccess(const nlohmann::json& data, const std::string& message
     }
 }
 
+void Response::setRaw(const std::string& json) {
+    rawBody = json;
+}
+
 std::string Response::toString() const {
+    if (!rawBody.empty()) {
+        return rawBody;
+    }
     return body.dump(2);
 }
 
@@ -59,7 +66,7 @@ std::string Response::toHttpResponse() const {
     oss << "Access-Control-Allow-Methods: GET, POST, PUT, DELETE, OPTIONS\r\n";
     oss << "Access-Control-Allow-Headers: Content-Type, Authorization\r\n";
     
-    std::string bodyStr = body.dump();
+    std::string bodyStr = rawBody.empty() ? body.dump() : rawBody;
     oss << "Content-Length: " << bodyStr.length() << "\r\n";
     oss << "\r\n";
     oss << bodyStr;
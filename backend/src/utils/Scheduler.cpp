@@ -0,0 +1,102 @@
+#include "utils/Scheduler.h"
+#include "utils/Config.h"
+#include "utils/DateUtils.h"
+#include <chrono>
+#include <iostream>
+
+Scheduler::Scheduler() : stopping(false) {
+    utcOffsetMinutes = Config::getInstance()->getInt("/scheduler/utcOffsetMinutes", 330);
+}
+
+Scheduler::~Scheduler() {
+    {
+        std::lock_guard<std::mutex> lock(scheduleMutex);
+        stopping = true;
+    }
+    scheduleCv.notify_all();
+    if (worker.joinable()) {
+        worker.join();
+    }
+}
+
+Scheduler* Scheduler::getInstance() {
+    static Scheduler instance;
+    return &instance;
+}
+
+std::time_t Scheduler::nextRun(int minuteOfDay, std::time_t after) const {
+    const std::time_t offset = static_cast<std::time_t>(utcOffsetMinutes) * 60;
+    std::time_t localMidnight = (after + offset) / 86400 * 86400 - offset;
+    
+    std::time_t runAt = localMidnight + static_cast<std::time_t>(minuteOfDay) * 60;
+    if (runAt <= after) {
+        runAt += 86400;
+    }
+    return runAt;
+}
+
+int Scheduler::localToday() const {
+    return localDay(std::time(nullptr));
+}
+
+int Scheduler::localDay(std::time_t at) const {
+    return static_cast<int>((at + static_cast<std::time_t>(utcOffsetMinutes) * 60) / 86400);
+}
+
+bool Scheduler::scheduleDaily(const std::string& name, const std::string& clockTime, Job job) {
+    int minuteOfDay = DateUtils::parseClockMinutes(clockTime);
+    if (minuteOfDay < 0 || minuteOfDay >= 24 * 60) {
+        std::cerr << "Invalid time '" << clockTime << "' for job " << name << std::endl;
+        return false;
+    }
+    
+    std::lock_guard<std::mutex> lock(scheduleMutex);
+    entries.push_back({name, minuteOfDay, std::move(job)});
+    due.push({nextRun(minuteOfDay, std::time(nullptr)), entries.size() - 1});
+    scheduleCv.notify_all();
+    return true;
+}
+
+void Scheduler::start() {
+    std::lock_guard<std::mutex> lock(scheduleMutex);
+    if (!worker.joinable()) {
+        worker = std::thread(&Scheduler::run, this);
+    }
+}
+
+void Scheduler::run() {
+    std::unique_lock<std::mutex> lock(scheduleMutex);
+    while (!stopping) {
+        if (due.empty()) {
+            scheduleCv.wait(lock);
+            continue;
+        }
+        
+        // Re-check after every wake-up: the clock may have been adjusted or
+        // an earlier job registered meanwhile
+        Due next = due.top();
+        if (next.runAt > std::time(nullptr)) {
+            scheduleCv.wait_until(lock, std::chrono::system_clock::from_time_t(next.runAt));
+            continue;
+        }
+        
+        due.pop();
+        const Entry& entry = entries[next.entryIndex];
+        std::string name = entry.name;
+        Job job = entry.job;
+        // Missed runs (the process was suspended) are not replayed
+        due.push({nextRun(entry.minuteOfDay, std::time(nullptr)), next.entryIndex});
+        
+        lock.unlock();
+        auto started = std::chrono::steady_clock::now();
+        try {
+            job();
+            auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(
+                std::chrono::steady_clock::now() - started).count();
+            std::cout << "Scheduled job " << name << " finished in " << elapsed << " ms" << std::endl;
+        } catch (const std::exception& e) {
+            std::cerr << "Scheduled job " << name << " failed: " << e.what() << std::endl;
+        }
+        lock.lock();
+    }
+}
@@ -0,0 +1,147 @@
+#include "utils/SearchCache.h"
+#include "utils/Config.h"
+#include "utils/DataStore.h"
+#include <algorithm>
+#include <functional>
+#include <mutex>
+#include <iostream>
+
+SearchCache::SearchCache() {
+    int maxEntries = Config::getInstance()->getInt("/searchCache/maxEntries", 20000);
+    maxEntriesPerShard = maxEntries > 0 ? static_cast<size_t>(maxEntries) / SHARD_COUNT + 1 : 0;
+    for (auto& shard : shards) {
+        shard.epoch = 0;
+    }
+}
+
+SearchCache* SearchCache::getInstance() {
+    static SearchCache instance;
+    return &instance;
+}
+
+std::string SearchCache::makeKey(const std::string& from, const std::string& to,
+                                 const std::string& journeyDate) {
+    return from + "|" + to + "|" + journeyDate;
+}
+
+SearchCache::Shard& SearchCache::shardFor(const std::string& key) {
+    return shards[std::hash<std::string>()(key) % SHARD_COUNT];
+}
+
+void SearchCache::start() {
+    // Trains and their routes are fixed after load
+    DataStore::getInstance()->forEachTrain([this](Train& train) {
+        std::vector<std::string> stops = train.getStops();
+        std::vector<std::string>& routes = routesByTrain[train.getTrainNumber()];
+        for (size_t i = 0; i < stops.size(); i++) {
+            for (size_t j = i + 1; j < stops.size(); j++) {
+                routes.push_back(stops[i] + "|" + stops[j]);
+            }
+        }
+    });
+    
+    EventBus::getInstance()->subscribe(
+        "search-cache",
+        [this](const BookingEvent& event) { apply(event); },
+        [this](uint64_t) { clear(); }
+    );
+}
+
+void SearchCache::apply(const BookingEvent& event) {
+    if (event.type != BookingEventType::SeatsReserved &&
+        event.type != BookingEventType::SeatsReleased) {
+        return;
+    }
+    
+    auto routes = routesByTrain.find(event.trainNumber);
+    if (routes == routesByTrain.end()) {
+        return;
+    }
+    
+    for (const auto& route : routes->second) {
+        std::string key = route + "|" + event.journeyDate;
+        Shard& shard = shardFor(key);
+        std::unique_lock<std::shared_mutex> lock(shard.mutex);
+        shard.responses.erase(key);
+        shard.epoch++;
+    }
+}
+
+void SearchCache::clear() {
+    // The consumer lost events, so any entry may be stale
+    for (auto& shard : shards) {
+        std::unique_lock<std::shared_mutex> lock(shard.mutex);
+        shard.responses.clear();
+        shard.epoch++;
+    }
+    std::cout << "Search cache cleared after lost events" << std::endl;
+}
+
+void SearchCache::reserve(size_t additionalEntries) {
+    size_t perShard = additionalEntries / SHARD_COUNT + 1;
+    for (auto& shard : shards) {
+        std::unique_lock<std::shared_mutex> lock(shard.mutex);
+        shard.responses.reserve(std::min(shard.responses.size() + perShard, maxEntriesPerShard));
+    }
+}
+
+bool SearchCache::lookup(const std::string& key, std::string& responseJson) {
+    Shard& shard = shardFor(key);
+    std::shared_lock<std::shared_mutex> lock(shard.mutex);
+    
+    auto it = shard.responses.find(key);
+    if (it == shard.responses.end()) {
+        return false;
+    }
+    responseJson = it->second;
+    return true;
+}
+
+uint64_t SearchCache::getEpoch(const std::string& key) {
+    Shard& shard = shardFor(key);
+    std::shared_lock<std::shared_mutex> lock(shard.mutex);
+    return shard.epoch;
+}
+
+bool SearchCache::store(const std::string& key, const std::string& responseJson, uint64_t epoch) {
+    Shard& shard = shardFor(key);
+    std::unique_lock<std::shared_mutex> lock(shard.mutex);
+    
+    if (shard.epoch != epoch) {
+        return false;
+    }
+    if (shard.responses.size() >= maxEntriesPerShard && shard.responses.count(key) == 0) {
+        return false;
+    }
+    
+    shard.responses[key] = responseJson;
+    return true;
+}
+
+size_t SearchCache::dropBefore(const std::string& journeyDate) {
+    // Keys end in the YYYY-MM-DD date, which sorts as a string
+    size_t dropped = 0;
+    for (auto& shard : shards) {
+        std::unique_lock<std::shared_mutex> lock(shard.mutex);
+        for (auto it = shard.responses.begin(); it != shard.responses.end(); ) {
+            const std::string& key = it->first;
+            if (key.size() >= journeyDate.size() &&
+                key.compare(key.size() - journeyDate.size(), journeyDate.size(), journeyDate) < 0) {
+                it = shard.responses.erase(it);
+                dropped++;
+            } else {
+                ++it;
+            }
+        }
+    }
+    return dropped;
+}
+
+size_t SearchCache::size() {
+    size_t total = 0;
+    for (auto& shard : shards) {
+        std::shared_lock<std::shared_mutex> lock(shard.mutex);
+        total += shard.responses.size();
+    }
+    return total;
+}
@@ -0,0 +1,191 @@
+#include "utils/SeatHoldManager.h"
+#include "utils/EventBus.h"
+#include "utils/WaitlistManager.h"
+#include <chrono>
+#include <iostream>
+
+std::string SeatHold::getHoldId() const {
+    return "hold_" + std::to_string(serial);
+}
+
+nlohmann::json SeatHold::toJson() const {
+    return {
+        {"holdId", getHoldId()},
+        {"trainNumber", trainNumber},
+        {"journeyDate", journeyDate},
+        {"class", classCode},
+        {"quota", quotaCode(quota)},
+        {"seats", seats},
+        {"expiresAt", static_cast<long long>(expiresAt)}
+    };
+}
+
+SeatHoldManager::SeatHoldManager() 
+    : expiryWheel(static_cast<uint64_t>(std::time(nullptr))), 
+      nextSerial(1), stopping(false) {
+    expiryThread = std::thread(&SeatHoldManager::runExpiryLoop, this);
+}
+
+SeatHoldManager::~SeatHoldManager() {
+    {
+        std::lock_guard<std::mutex> lock(holdMutex);
+        stopping = true;
+    }
+    expiryCv.notify_all();
+    if (expiryThread.joinable()) {
+        expiryThread.join();
+    }
+}
+
+SeatHoldManager* SeatHoldManager::getInstance() {
+    static SeatHoldManager instance;
+    return &instance;
+}
+
+bool SeatHoldManager::parseHoldId(const std::string& holdId, uint64_t& serial) {
+    if (holdId.compare(0, 5, "hold_") != 0 || holdId.length() <= 5) {
+        return false;
+    }
+    try {
+        serial = std::stoull(holdId.substr(5));
+    } catch (const std::exception&) {
+        return false;
+    }
+    return true;
+}
+
+void SeatHoldManager::runExpiryLoop() {
+    std::unique_lock<std::mutex> lock(holdMutex);
+    while (!stopping) {
+        expiryCv.wait_for(lock, std::chrono::seconds(1));
+        if (stopping) break;
+        
+        lock.unlock();
+        expireDue(std::time(nullptr));
+        lock.lock();
+    }
+}
+
+void SeatHoldManager::expireDue(std::time_t now) {
+    std::vector<uint64_t> due;
+    std::vector<SeatHold> expired;
+    
+    {
+        std::lock_guard<std::mutex> lock(holdMutex);
+        expiryWheel.advance(static_cast<uint64_t>(now), due);
+        
+        for (uint64_t serial : due) {
+            auto it = holds.find(serial);
+            if (it == holds.end()) continue; // Confirmed or released earlier
+            
+            expired.push_back(it->second);
+            holds.erase(it);
+        }
+    }
+    
+    WaitlistManager* waitlist = WaitlistManager::getInstance();
+    for (const auto& hold : expired) {
+        waitlist->releaseSeats(hold.trainNumber, hold.journeyDate, hold.classCode,
+                               hold.counter, hold.seats, hold.quota);
+    }
+    
+    if (!expired.empty()) {
+        std::cout << "Expired " << expired.size() << " seat hold(s)" << std::endl;
+    }
+}
+
+bool SeatHoldManager::placeHold(const std::string& userId, const Train& train,
+                                const std::string& journeyDate, const std::string& classCode,
+                                Quota quota, int seats, int ttlSeconds, SeatHold& hold) {
+    InventoryCounter* counter = SeatInventory::getInstance()->getCounter(train, journeyDate, classCode);
+    if (!SeatInventory::tryReserve(counter, seats, quota)) {
+        return false;
+    }
+    
+    if (ttlSeconds <= 0) ttlSeconds = DEFAULT_TTL_SECONDS;
+    if (ttlSeconds > MAX_TTL_SECONDS) ttlSeconds = MAX_TTL_SECONDS;
+    
+    hold.userId = userId;
+    hold.trainNumber = train.getTrainNumber();
+    hold.journeyDate = journeyDate;
+    hold.classCode = classCode;
+    hold.quota = quota;
+    hold.seats = seats;
+    hold.counter = counter;
+    hold.expiresAt = std::time(nullptr) + ttlSeconds;
+    
+    std::lock_guard<std::mutex> lock(holdMutex);
+    hold.serial = nextSerial++;
+    holds[hold.serial] = hold;
+    expiryWheel.schedule(hold.serial, static_cast<uint64_t>(hold.expiresAt));
+    
+    EventBus::getInstance()->publish(BookingEvent::forInventory(
+        BookingEventType::SeatsReserved, hold.trainNumber, journeyDate, classCode, seats,
+        counter->general().load(std::memory_order_relaxed)));
+    
+    return true;
+}
+
+InventoryCounter* SeatHoldManager::confirmHold(const std::string& holdId, 
+                                               const std::string& userId,
+                                               const std::string& trainNumber,
+                                               const std::string& journeyDate,
+                                               const std::string& classCode, 
+                                               Quota quota, int seats) {
+    uint64_t serial;
+    if (!parseHoldId(holdId, serial)) {
+        return nullptr;
+    }
+    
+    std::lock_guard<std::mutex> lock(holdMutex);
+    
+    auto it = holds.find(serial);
+    if (it == holds.end()) {
+        return nullptr;
+    }
+    
+    const SeatHold& hold = it->second;
+    if (hold.userId != userId || hold.trainNumber != trainNumber ||
+        hold.journeyDate != journeyDate || hold.classCode != classCode || 
+        hold.quota != quota || hold.seats != seats) {
+        return nullptr;
+    }
+    
+    // Past its TTL but not yet reaped by the expiry thread
+    if (hold.expiresAt <= std::time(nullptr)) {
+        return nullptr;
+    }
+    
+    InventoryCounter* counter = hold.counter;
+    holds.erase(it);
+    return counter;
+}
+
+bool SeatHoldManager::releaseHold(const std::string& holdId, const std::string& userId) {
+    uint64_t serial;
+    if (!parseHoldId(holdId, serial)) {
+        return false;
+    }
+    
+    SeatHold hold;
+    {
+        std::lock_guard<std::mutex> lock(holdMutex);
+        
+        auto it = holds.find(serial);
+        if (it == holds.end() || it->second.userId != userId) {
+            return false;
+        }
+        
+        hold = it->second;
+        holds.erase(it);
+    }
+    
+    WaitlistManager::getInstance()->releaseSeats(hold.trainNumber, hold.journeyDate,
+                                                 hold.classCode, hold.counter, hold.seats, hold.quota);
+    return true;
+}
+
+size_t SeatHoldManager::getActiveHoldCount() {
+    std::lock_guard<std::mutex> lock(holdMutex);
+    return holds.size();
+}
@@ -0,0 +1,184 @@
+#include "utils/SeatInventory.h"
+#include <functional>
+#include <mutex>
+
+bool parseQuota(const std::string& code, Quota& quota) {
+    if (code.empty() || code == "GN") quota = Quota::General;
+    else if (code == "TQ") quota = Quota::Tatkal;
+    else if (code == "LD") quota = Quota::Ladies;
+    else if (code == "SS") quota = Quota::Senior;
+    else return false;
+    return true;
+}
+
+std::string quotaCode(Quota quota) {
+    switch (quota) {
+        case Quota::Tatkal: return "TQ";
+        case Quota::Ladies: return "LD";
+        case Quota::Senior: return "SS";
+        default: return "GN";
+    }
+}
+
+static_assert(sizeof(InventoryCounter) == 64, "Quota counters must fit in one cache line");
+
+InventoryCounter::InventoryCounter(const int (&seeds)[QUOTA_COUNT], int totalSeats, int initialWaitlist)
+    : totalSeats(totalSeats), initialWaitlist(initialWaitlist) {
+    for (int i = 0; i < QUOTA_COUNT; i++) {
+        quotaSeats[i].store(seeds[i], std::memory_order_relaxed);
+    }
+}
+
+SeatInventory::SeatInventory() {}
+
+SeatInventory* SeatInventory::getInstance() {
+    // Function-local static: first use may come from any request thread
+    static SeatInventory instance;
+    return &instance;
+}
+
+std::string SeatInventory::makeKey(const std::string& trainNumber,
+                                   const std::string& journeyDate,
+                                   const std::string& classCode) {
+    return trainNumber + "|" + journeyDate + "|" + classCode;
+}
+
+SeatInventory::Shard& SeatInventory::shardFor(const std::string& key) {
+    return shards[std::hash<std::string>()(key) % SHARD_COUNT];
+}
+
+void SeatInventory::splitIntoQuotas(const std::string& classCode, int available,
+                                    int (&seeds)[QUOTA_COUNT]) {
+    // Tatkal is 10% of the class except in First AC and Executive Chair Car;
+    // senior citizen and ladies quotas take a sixteenth and a thirty-second
+    int tatkal = (classCode == "1A" || classCode == "EC") ? 0 : available / 10;
+    int senior = available / 16;
+    int ladies = available / 32;
+    
+    seeds[static_cast<int>(Quota::Tatkal)] = tatkal;
+    seeds[static_cast<int>(Quota::Senior)] = senior;
+    seeds[static_cast<int>(Quota::Ladies)] = ladies;
+    seeds[static_cast<int>(Quota::General)] = available - tatkal - senior - ladies;
+}
+
+void SeatInventory::reserve(size_t additionalCounters) {
+    size_t perShard = additionalCounters / SHARD_COUNT + 1;
+    for (auto& shard : shards) {
+        std::unique_lock<std::shared_mutex> lock(shard.mutex);
+        shard.counters.reserve(shard.counters.size() + perShard);
+    }
+}
+
+InventoryCounter* SeatInventory::getCounter(const Train& train,
+                                            const std::string& journeyDate,
+                                            const std::string& classCode) {
+    std::string key = makeKey(train.getTrainNumber(), journeyDate, classCode);
+    Shard& shard = shardFor(key);
+    
+    {
+        std::shared_lock<std::shared_mutex> lock(shard.mutex);
+        auto it = shard.counters.find(key);
+        if (it != shard.counters.end()) {
+            return it->second.get();
+        }
+    }
+    
+    // First booking for this date: seed from the stored class availability
+    const TrainAvailability* seed = nullptr;
+    for (const auto& avail : train.getAvailabilityRef()) {
+        if (avail.classCode == classCode) {
+            seed = &avail;
+            break;
+        }
+    }
+    if (!seed) {
+        return nullptr;
+    }
+    
+    // Negative availability means the class is already waitlisted
+    int available = seed->availableSeats > 0 ? seed->availableSeats : 0;
+    int waitlisted = seed->availableSeats < 0 ? -seed->availableSeats : 0;
+    
+    int seeds[QUOTA_COUNT];
+    splitIntoQuotas(classCode, available, seeds);
+    
+    std::unique_lock<std::shared_mutex> lock(shard.mutex);
+    auto& slot = shard.counters[key];
+    if (!slot) {
+        slot.reset(new InventoryCounter(seeds, seed->totalSeats, waitlisted));
+    }
+    return slot.get();
+}
+
+bool SeatInventory::tryReserve(InventoryCounter* counter, int seats, Quota quota) {
+    if (!counter || seats <= 0) {
+        return false;
+    }
+    
+    std::atomic<int>& pool = counter->quotaSeats[static_cast<int>(quota)];
+    int current = pool.load(std::memory_order_relaxed);
+    while (current >= seats) {
+        if (pool.compare_exchange_weak(current, current - seats,
+                                       std::memory_order_acq_rel,
+                                       std::memory_order_relaxed)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+void SeatInventory::release(InventoryCounter* counter, int seats, Quota quota) {
+    if (!counter || seats <= 0) {
+        return;
+    }
+    counter->quotaSeats[static_cast<int>(quota)].fetch_add(seats, std::memory_order_acq_rel);
+}
+
+int SeatInventory::drainSpecialQuotas(InventoryCounter* counter) {
+    if (!counter) {
+        return 0;
+    }
+    
+    int drained = 0;
+    for (int i = 0; i < QUOTA_COUNT; i++) {
+        if (i != static_cast<int>(Quota::General)) {
+            drained += counter->quotaSeats[i].exchange(0, std::memory_order_acq_rel);
+        }
+    }
+    return drained;
+}
+
+bool SeatInventory::tryReserve(const Train& train, const std::string& journeyDate,
+                               const std::string& classCode, int seats) {
+    return tryReserve(getCounter(train, journeyDate, classCode), seats);
+}
+
+bool SeatInventory::release(const Train& train, const std::string& journeyDate,
+                            const std::string& classCode, int seats) {
+    InventoryCounter* counter = getCounter(train, journeyDate, classCode);
+    if (!counter) {
+        return false;
+    }
+    release(counter, seats);
+    return true;
+}
+
+int SeatInventory::getAvailableSeats(const Train& train, const std::string& journeyDate,
+                                     const std::string& classCode, Quota quota) {
+    std::string key = makeKey(train.getTrainNumber(), journeyDate, classCode);
+    Shard& shard = shardFor(key);
+    
+    {
+        std::shared_lock<std::shared_mutex> lock(shard.mutex);
+        auto it = shard.counters.find(key);
+        if (it != shard.counters.end()) {
+            return it->second->quotaSeats[static_cast<int>(quota)].load(std::memory_order_acquire);
+        }
+    }
+    
+    // Same split the counter would be seeded with
+    int stored = train.getAvailableSeats(classCode);
+    int seeds[QUOTA_COUNT];
+    splitIntoQuotas(classCode, stored > 0 ? stored : 0, seeds);
+    return quota == Quota::General && stored < 0 ? stored : seeds[static_cast<int>(quota)];
+}
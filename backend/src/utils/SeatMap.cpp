@@ -0,0 +1,771 @@
+#include "utils/SeatMap.h"
+#include <algorithm>
+#include <functional>
+#include <mutex>
+#include <numeric>
+#include <random>
+
+namespace {
+
+// Nearest alternatives when the preferred berth is gone. Seat comes last
+// so a berth preference still gets a seat in a chair car class.
+const BerthType FALLBACK_ORDER[BERTH_TYPE_COUNT][BERTH_TYPE_COUNT] = {
+    {BerthType::Lower, BerthType::SideLower, BerthType::Middle, BerthType::Upper, BerthType::SideUpper, BerthType::Seat},
+    {BerthType::Middle, BerthType::Lower, BerthType::Upper, BerthType::SideLower, BerthType::SideUpper, BerthType::Seat},
+    {BerthType::Upper, BerthType::SideUpper, BerthType::Middle, BerthType::Lower, BerthType::SideLower, BerthType::Seat},
+    {BerthType::SideLower, BerthType::Lower, BerthType::SideUpper, BerthType::Middle, BerthType::Upper, BerthType::Seat},
+    {BerthType::SideUpper, BerthType::Upper, BerthType::SideLower, BerthType::Middle, BerthType::Lower, BerthType::Seat},
+    {BerthType::Seat, BerthType::Seat, BerthType::Seat, BerthType::Seat, BerthType::Seat, BerthType::Seat}
+};
+
+}
+
+SeatMap::SeatMap(int coachCount, const CoachLayout& layout, int legCount)
+    : coachCount(std::max(1, coachCount)),
+      layout(layout),
+      coaches(new CoachBits[std::max(1, coachCount)]),
+      firstOpenCoach(0),
+      summaryWords((std::max(1, coachCount) + 63) / 64),
+      berthSummary(new std::atomic<uint64_t>[BERTH_TYPE_COUNT * ((std::max(1, coachCount) + 63) / 64)]) {
+    this->layout.seatsPerCoach = std::min(std::max(1, layout.seatsPerCoach), MAX_SEATS_PER_COACH);
+    
+    int lowSeats = std::min(this->layout.seatsPerCoach, 64);
+    int highSeats = this->layout.seatsPerCoach - lowSeats;
+    seatMask[0] = lowSeats == 64 ? ~0ULL : (1ULL << lowSeats) - 1;
+    seatMask[1] = highSeats == 64 ? ~0ULL : (1ULL << highSeats) - 1;
+    
+    for (int t = 0; t < BERTH_TYPE_COUNT; t++) {
+        berthMask[t][0] = 0;
+        berthMask[t][1] = 0;
+    }
+    for (int seat = 1; seat <= this->layout.seatsPerCoach; seat++) {
+        int type = static_cast<int>(this->layout.berthAt(seat));
+        berthMask[type][(seat - 1) / 64] |= 1ULL << ((seat - 1) % 64);
+    }
+    
+    for (int c = 0; c < this->coachCount; c++) {
+        coaches[c].words[0].store(0, std::memory_order_relaxed);
+        coaches[c].words[1].store(0, std::memory_order_relaxed);
+    }
+    
+    // Every coach starts with every berth type it has
+    for (int t = 0; t < BERTH_TYPE_COUNT; t++) {
+        bool present = (berthMask[t][0] | berthMask[t][1]) != 0;
+        for (int k = 0; k < summaryWords; k++) {
+            int coachesInWord = std::min(64, this->coachCount - k * 64);
+            uint64_t bits = coachesInWord == 64 ? ~0ULL : (1ULL << coachesInWord) - 1;
+            berthSummary[t * summaryWords + k].store(present ? bits : 0, std::memory_order_relaxed);
+        }
+    }
+    
+    this->layout.baySeats = std::max(4, layout.baySeats);
+    bayCount = std::min((this->layout.seatsPerCoach + this->layout.baySeats - 1) / this->layout.baySeats, MAX_BAYS);
+    for (int b = 0; b < bayCount; b++) {
+        bayMask[b][0] = 0;
+        bayMask[b][1] = 0;
+        int first = b * this->layout.baySeats;
+        int last = std::min(first + this->layout.baySeats, this->layout.seatsPerCoach);
+        for (int index = first; index < last; index++) {
+            bayMask[b][index / 64] |= 1ULL << (index % 64);
+        }
+    }
+    
+    int groupSizes = MAX_GROUP_SIZE - 1;
+    bayFitSummary.reset(new std::atomic<uint64_t>[groupSizes * summaryWords]);
+    pairFitSummary.reset(new std::atomic<uint64_t>[groupSizes * summaryWords]);
+    for (int count = 2; count <= MAX_GROUP_SIZE; count++) {
+        bool fitsBay = count <= this->layout.baySeats;
+        bool fitsPair = bayCount > 1 && count <= 2 * this->layout.baySeats;
+        for (int k = 0; k < summaryWords; k++) {
+            int coachesInWord = std::min(64, this->coachCount - k * 64);
+            uint64_t bits = coachesInWord == 64 ? ~0ULL : (1ULL << coachesInWord) - 1;
+            int slot = (count - 2) * summaryWords + k;
+            bayFitSummary[slot].store(fitsBay ? bits : 0, std::memory_order_relaxed);
+            pairFitSummary[slot].store(fitsPair ? bits : 0, std::memory_order_relaxed);
+        }
+    }
+    
+    this->legCount = std::min(std::max(1, legCount), MAX_LEGS);
+    if (this->legCount > 1) {
+        size_t seatCount = static_cast<size_t>(this->coachCount) * this->layout.seatsPerCoach;
+        legMasks.reset(new std::atomic<uint64_t>[seatCount]);
+        for (size_t i = 0; i < seatCount; i++) {
+            legMasks[i].store(0, std::memory_order_relaxed);
+        }
+    }
+}
+
+std::atomic<uint64_t>& SeatMap::summaryFor(BerthType type, int coach) {
+    return berthSummary[static_cast<int>(type) * summaryWords + coach / 64];
+}
+
+bool SeatMap::hasFreeBerth(int coach, BerthType type) const {
+    const uint64_t* mask = berthMask[static_cast<int>(type)];
+    return ((~coaches[coach].words[0].load(std::memory_order_acquire) & mask[0]) |
+            (~coaches[coach].words[1].load(std::memory_order_acquire) & mask[1])) != 0;
+}
+
+bool SeatMap::claimBerth(int coach, BerthType type, SeatRef& seat) {
+    return claimInMask(coach, berthMask[static_cast<int>(type)], seat);
+}
+
+bool SeatMap::claimInMask(int coach, const uint64_t mask[2], SeatRef& seat) {
+    for (int w = 0; w < 2; w++) {
+        std::atomic<uint64_t>& word = coaches[coach].words[w];
+        uint64_t current = word.load(std::memory_order_relaxed);
+        uint64_t freeBits;
+        while ((freeBits = ~current & mask[w]) != 0) {
+            uint64_t bit = freeBits & (~freeBits + 1);
+            if (word.compare_exchange_weak(current, current | bit,
+                                           std::memory_order_acq_rel,
+                                           std::memory_order_relaxed)) {
+                seat = {coach + 1, w * 64 + __builtin_ctzll(bit) + 1};
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+bool SeatMap::allocatePreferred(BerthType preferred, SeatRef& seat) {
+    for (BerthType type : FALLBACK_ORDER[static_cast<int>(preferred)]) {
+        int t = static_cast<int>(type);
+        if ((berthMask[t][0] | berthMask[t][1]) == 0) {
+            continue; // The class has no such berth
+        }
+        
+        for (int k = 0; k < summaryWords; k++) {
+            std::atomic<uint64_t>& summary = berthSummary[t * summaryWords + k];
+            uint64_t candidates = summary.load(std::memory_order_acquire);
+            while (candidates != 0) {
+                int coach = k * 64 + __builtin_ctzll(candidates);
+                if (claimBerth(coach, type, seat)) {
+                    return true;
+                }
+                
+                // Clear, then re-check so a release racing with us is not hidden
+                uint64_t bit = 1ULL << (coach % 64);
+                summary.fetch_and(~bit, std::memory_order_acq_rel);
+                if (hasFreeBerth(coach, type)) {
+                    summary.fetch_or(bit, std::memory_order_acq_rel);
+                    if (claimBerth(coach, type, seat)) {
+                        return true;
+                    }
+                }
+                candidates &= candidates - 1;
+            }
+        }
+    }
+    return false;
+}
+
+int SeatMap::freeInBay(uint64_t free0, uint64_t free1, int bay) const {
+    return __builtin_popcountll(free0 & bayMask[bay][0]) + __builtin_popcountll(free1 & bayMask[bay][1]);
+}
+
+int SeatMap::findBays(int coach, int span, int count) const {
+    uint64_t free0 = ~coaches[coach].words[0].load(std::memory_order_acquire) & seatMask[0];
+    uint64_t free1 = ~coaches[coach].words[1].load(std::memory_order_acquire) & seatMask[1];
+    if (__builtin_popcountll(free0) + __builtin_popcountll(free1) < count) {
+        return -1;
+    }
+    
+    // Free seats per bay, then the first run of span bays with enough room
+    int window = 0;
+    for (int b = 0; b < bayCount; b++) {
+        window += freeInBay(free0, free1, b);
+        if (b >= span) {
+            window -= freeInBay(free0, free1, b - span);
+        }
+        if (b >= span - 1 && window >= count) {
+            return b - span + 1;
+        }
+    }
+    return -1;
+}
+
+bool SeatMap::claimBays(int coach, int firstBay, int span, int count, std::vector<SeatRef>& seats) {
+    uint64_t mask[2] = {0, 0};
+    for (int b = firstBay; b < firstBay + span; b++) {
+        mask[0] |= bayMask[b][0];
+        mask[1] |= bayMask[b][1];
+    }
+    
+    size_t start = seats.size();
+    int needed = count;
+    for (int w = 0; w < 2 && needed > 0; w++) {
+        std::atomic<uint64_t>& word = coaches[coach].words[w];
+        uint64_t current = word.load(std::memory_order_relaxed);
+        uint64_t take;
+        do {
+            uint64_t freeBits = ~current & mask[w];
+            take = 0;
+            for (int taken = 0; freeBits != 0 && taken < needed; taken++) {
+                take |= freeBits & (~freeBits + 1);
+                freeBits &= freeBits - 1;
+            }
+        } while (take != 0 && !word.compare_exchange_weak(current, current | take,
+                                                          std::memory_order_acq_rel,
+                                                          std::memory_order_relaxed));
+        
+        while (take != 0) {
+            seats.push_back({coach + 1, w * 64 + __builtin_ctzll(take) + 1});
+            take &= take - 1;
+            needed--;
+        }
+    }
+    
+    // Another booking took seats in the bay since findBays looked
+    if (needed > 0) {
+        for (size_t i = start; i < seats.size(); i++) {
+            release(seats[i]);
+        }
+        seats.resize(start);
+        return false;
+    }
+    return true;
+}
+
+bool SeatMap::allocateInBays(int span, int count, std::vector<SeatRef>& seats) {
+    std::atomic<uint64_t>* summary = (span == 1 ? bayFitSummary : pairFitSummary).get() +
+                                     (count - 2) * summaryWords;
+    
+    for (int k = 0; k < summaryWords; k++) {
+        uint64_t candidates = summary[k].load(std::memory_order_acquire);
+        while (candidates != 0) {
+            int coach = k * 64 + __builtin_ctzll(candidates);
+            int bay = findBays(coach, span, count);
+            if (bay >= 0) {
+                if (claimBays(coach, bay, span, count, seats)) {
+                    return true;
+                }
+                continue; // Lost a race for the bay; look at the coach again
+            }
+            
+            // Clear, then re-check so a release racing with us is not hidden
+            uint64_t bit = 1ULL << (coach % 64);
+            summary[k].fetch_and(~bit, std::memory_order_acq_rel);
+            if (findBays(coach, span, count) >= 0) {
+                summary[k].fetch_or(bit, std::memory_order_acq_rel);
+                continue;
+            }
+            candidates &= candidates - 1;
+        }
+    }
+    return false;
+}
+
+bool SeatMap::allocateGroup(int count, std::vector<SeatRef>& seats) {
+    if (count < 2 || count > MAX_GROUP_SIZE) {
+        return allocate(count, seats);
+    }
+    
+    if (allocateInBays(1, count, seats) || allocateInBays(2, count, seats)) {
+        return true;
+    }
+    
+    // No room for the party anywhere together
+    return allocate(count, seats);
+}
+
+int SeatMap::baySpan(const std::vector<SeatRef>& seats) const {
+    int lowest = MAX_BAYS;
+    int highest = -1;
+    for (const auto& seat : seats) {
+        if (seat.coach != seats[0].coach) {
+            return MAX_BAYS;
+        }
+        int bay = (seat.seat - 1) / layout.baySeats;
+        lowest = std::min(lowest, bay);
+        highest = std::max(highest, bay);
+    }
+    return highest - lowest + 1;
+}
+
+bool SeatMap::claimRegroup(const std::vector<SeatRef>& seats, std::vector<SeatRef>& targets) {
+    int count = static_cast<int>(seats.size());
+    if (count < 2 || count > MAX_GROUP_SIZE) {
+        return false;
+    }
+    int currentSpan = baySpan(seats);
+    
+    for (int span = 1; span <= 2 && span < currentSpan; span++) {
+        // Cheapest window of span bays in a coach the party already uses:
+        // its seats there stay, the rest move in
+        int bestCoach = -1;
+        int bestBay = -1;
+        int bestCost = count;
+        for (size_t i = 0; i < seats.size(); i++) {
+            int coach = seats[i].coach - 1;
+            if (coach < 0 || coach >= coachCount ||
+                std::any_of(seats.begin(), seats.begin() + i,
+                            [&](const SeatRef& other) { return other.coach == seats[i].coach; })) {
+                continue;
+            }
+            uint64_t free0 = ~coaches[coach].words[0].load(std::memory_order_acquire) & seatMask[0];
+            uint64_t free1 = ~coaches[coach].words[1].load(std::memory_order_acquire) & seatMask[1];
+            
+            for (int first = 0; first + span <= bayCount; first++) {
+                int held = 0;
+                int room = 0;
+                for (int b = first; b < first + span; b++) {
+                    room += freeInBay(free0, free1, b);
+                }
+                for (const auto& seat : seats) {
+                    int bay = (seat.seat - 1) / layout.baySeats;
+                    held += seat.coach == coach + 1 && bay >= first && bay < first + span;
+                }
+                if (held + room >= count && count - held < bestCost) {
+                    bestCoach = coach;
+                    bestBay = first;
+                    bestCost = count - held;
+                }
+            }
+        }
+        
+        std::vector<SeatRef> claimed;
+        if (bestCoach >= 0) {
+            if (!claimBays(bestCoach, bestBay, span, bestCost, claimed)) {
+                return false; // Lost a race; the next pass looks again
+            }
+        } else if (!allocateInBays(span, count, claimed)) {
+            continue;
+        } else {
+            bestBay = -1; // Everyone moves
+        }
+        
+        targets = seats;
+        size_t next = 0;
+        for (auto& target : targets) {
+            int bay = (target.seat - 1) / layout.baySeats;
+            bool stays = bestBay >= 0 && target.coach == bestCoach + 1 &&
+                         bay >= bestBay && bay < bestBay + span;
+            if (!stays) {
+                target = claimed[next++];
+            }
+        }
+        return true;
+    }
+    return false;
+}
+
+bool SeatMap::claimCompaction(const SeatRef& seat, SeatRef& target) {
+    int coach = seat.coach - 1;
+    int bay = (seat.seat - 1) / layout.baySeats;
+    if (coach < 0 || coach >= coachCount || bay >= bayCount) {
+        return false;
+    }
+    
+    auto bayFree = [this](int c, int b) {
+        uint64_t free0 = ~coaches[c].words[0].load(std::memory_order_acquire) & seatMask[0];
+        uint64_t free1 = ~coaches[c].words[1].load(std::memory_order_acquire) & seatMask[1];
+        return freeInBay(free0, free1, b);
+    };
+    auto baySize = [this](int b) {
+        return __builtin_popcountll(bayMask[b][0]) + __builtin_popcountll(bayMask[b][1]);
+    };
+    // Only towards a bay at least as full, so repeated moves drain the
+    // emptiest bays and always come to an end
+    int occupied = baySize(bay) - bayFree(coach, bay);
+    
+    const uint64_t* typeMask = berthMask[static_cast<int>(layout.berthAt(seat.seat))];
+    int bestCoach = -1;
+    int bestBay = -1;
+    int bestFree = 0;
+    for (int c = 0; c < coachCount; c++) {
+        uint64_t free0 = ~coaches[c].words[0].load(std::memory_order_acquire) & seatMask[0];
+        uint64_t free1 = ~coaches[c].words[1].load(std::memory_order_acquire) & seatMask[1];
+        for (int b = 0; b < bayCount; b++) {
+            int free = freeInBay(free0, free1, b);
+            bool hasType = ((free0 & bayMask[b][0] & typeMask[0]) |
+                            (free1 & bayMask[b][1] & typeMask[1])) != 0;
+            if (hasType && baySize(b) - free >= occupied && (bestCoach < 0 || free < bestFree) &&
+                (c != coach || b != bay)) {
+                bestCoach = c;
+                bestBay = b;
+                bestFree = free;
+            }
+        }
+    }
+    if (bestCoach < 0) {
+        return false;
+    }
+    
+    uint64_t mask[2] = {bayMask[bestBay][0] & typeMask[0], bayMask[bestBay][1] & typeMask[1]};
+    return claimInMask(bestCoach, mask, target);
+}
+
+int SeatMap::claimFromWord(std::atomic<uint64_t>& word, int wordIndex, int coach,
+                           int count, std::vector<SeatRef>& seats) {
+    uint64_t current = word.load(std::memory_order_relaxed);
+    while (true) {
+        uint64_t freeBits = ~current & seatMask[wordIndex];
+        if (freeBits == 0) {
+            return 0;
+        }
+        
+        // Lowest free bits first, so a group sits together
+        uint64_t take = 0;
+        int taken = 0;
+        while (freeBits != 0 && taken < count) {
+            take |= freeBits & (~freeBits + 1);
+            freeBits &= freeBits - 1;
+            taken++;
+        }
+        
+        if (word.compare_exchange_weak(current, current | take,
+                                       std::memory_order_acq_rel,
+                                       std::memory_order_relaxed)) {
+            while (take != 0) {
+                int bit = __builtin_ctzll(take);
+                seats.push_back({coach + 1, wordIndex * 64 + bit + 1});
+                take &= take - 1;
+            }
+            return taken;
+        }
+    }
+}
+
+bool SeatMap::allocate(int count, std::vector<SeatRef>& seats) {
+    if (count <= 0) {
+        return false;
+    }
+    
+    size_t start = seats.size();
+    int needed = count;
+    int hint = firstOpenCoach.load(std::memory_order_relaxed);
+    
+    auto scan = [&](int from, int to) {
+        for (int c = from; c < to && needed > 0; c++) {
+            CoachBits& coach = coaches[c];
+            needed -= claimFromWord(coach.words[0], 0, c, needed, seats);
+            if (needed > 0) {
+                needed -= claimFromWord(coach.words[1], 1, c, needed, seats);
+            }
+            
+            if (needed > 0 && c == hint) {
+                // Full: later searches can start past it
+                int expected = c;
+                firstOpenCoach.compare_exchange_strong(expected, c + 1, std::memory_order_relaxed);
+                hint = c + 1;
+            }
+        }
+    };
+    
+    scan(hint, coachCount);
+    
+    // The hint is only a shortcut; a seat freed behind it is still found
+    if (needed > 0 && hint > 0) {
+        scan(0, std::min(hint, coachCount));
+    }
+    
+    if (needed > 0) {
+        for (size_t i = start; i < seats.size(); i++) {
+            release(seats[i]);
+        }
+        seats.resize(start);
+        return false;
+    }
+    return true;
+}
+
+uint64_t SeatMap::legRange(int fromStop, int toStop) const {
+    int width = toStop - fromStop;
+    return (width >= 64 ? ~0ULL : (1ULL << width) - 1) << fromStop;
+}
+
+uint64_t SeatMap::partialSeats(int coach, int word, uint64_t legs) const {
+    // One branch-free pass over the coach's masks: seats sold on some legs
+    // and clear on all of these
+    int first = word * 64;
+    int last = std::min(first + 64, layout.seatsPerCoach);
+    const std::atomic<uint64_t>* masks = &legMasks[static_cast<size_t>(coach) * layout.seatsPerCoach];
+    
+    uint64_t seats = 0;
+    for (int i = first; i < last; i++) {
+        uint64_t mask = masks[i].load(std::memory_order_relaxed);
+        seats |= static_cast<uint64_t>((mask != 0) & ((mask & legs) == 0)) << (i - first);
+    }
+    return seats;
+}
+
+bool SeatMap::allocateSegment(int fromStop, int toStop, int count,
+                              std::vector<SeatRef>& seats, int& freshSeats) {
+    freshSeats = 0;
+    if (count <= 0 || fromStop < 0 || toStop > legCount || fromStop >= toStop) {
+        return false;
+    }
+    
+    if (!legMasks) {
+        if (!allocateGroup(count, seats)) {
+            return false;
+        }
+        freshSeats = count;
+        return true;
+    }
+    
+    uint64_t legs = legRange(fromStop, toStop);
+    size_t start = seats.size();
+    int needed = count;
+    
+    for (int c = 0; c < coachCount && needed > 0; c++) {
+        for (int w = 0; w * 64 < layout.seatsPerCoach && needed > 0; w++) {
+            uint64_t candidates = partialSeats(c, w, legs);
+            while (candidates != 0 && needed > 0) {
+                int index = w * 64 + __builtin_ctzll(candidates);
+                std::atomic<uint64_t>& mask = legMasks[static_cast<size_t>(c) * layout.seatsPerCoach + index];
+                uint64_t current = mask.load(std::memory_order_relaxed);
+                while (current != 0 && (current & legs) == 0) {
+                    if (mask.compare_exchange_weak(current, current | legs,
+                                                   std::memory_order_acq_rel,
+                                                   std::memory_order_relaxed)) {
+                        seats.push_back({c + 1, index + 1});
+                        needed--;
+                        break;
+                    }
+                }
+                candidates &= candidates - 1;
+            }
+        }
+    }
+    
+    // The rest take seats free end to end; the occupancy bit is set first,
+    // so until the mask is stored the seat reads as sold end to end
+    if (needed > 0) {
+        size_t freshStart = seats.size();
+        if (!allocateGroup(needed, seats)) {
+            for (size_t i = start; i < seats.size(); i++) {
+                releaseSegment(seats[i], fromStop, toStop);
+            }
+            seats.resize(start);
+            return false;
+        }
+        for (size_t i = freshStart; i < seats.size(); i++) {
+            size_t index = static_cast<size_t>(seats[i].coach - 1) * layout.seatsPerCoach + seats[i].seat - 1;
+            legMasks[index].store(legs, std::memory_order_release);
+        }
+        freshSeats = needed;
+    }
+    return true;
+}
+
+bool SeatMap::releaseSegment(const SeatRef& seat, int fromStop, int toStop) {
+    if (seat.coach < 1 || seat.coach > coachCount || seat.seat < 1 || seat.seat > layout.seatsPerCoach ||
+        fromStop < 0 || toStop > legCount || fromStop >= toStop) {
+        return false;
+    }
+    
+    if (!legMasks) {
+        release(seat);
+        return true;
+    }
+    
+    uint64_t legs = legRange(fromStop, toStop);
+    std::atomic<uint64_t>& mask = legMasks[static_cast<size_t>(seat.coach - 1) * layout.seatsPerCoach + seat.seat - 1];
+    uint64_t current = mask.load(std::memory_order_relaxed);
+    do {
+        if ((current & legs) != legs) {
+            return false; // Not held for these legs
+        }
+    } while (!mask.compare_exchange_weak(current, current & ~legs,
+                                         std::memory_order_acq_rel,
+                                         std::memory_order_relaxed));
+    
+    if ((current & ~legs) != 0) {
+        return false; // Still sold on other legs
+    }
+    release(seat);
+    return true;
+}
+
+bool SeatMap::occupy(const SeatRef& seat) {
+    if (seat.coach < 1 || seat.coach > coachCount || seat.seat < 1 || seat.seat > layout.seatsPerCoach) {
+        return false;
+    }
+    
+    int index = seat.seat - 1;
+    uint64_t bit = 1ULL << (index % 64);
+    uint64_t previous = coaches[seat.coach - 1].words[index / 64].fetch_or(bit, std::memory_order_acq_rel);
+    return (previous & bit) == 0;
+}
+
+void SeatMap::release(const SeatRef& seat) {
+    if (seat.coach < 1 || seat.coach > coachCount || seat.seat < 1 || seat.seat > layout.seatsPerCoach) {
+        return;
+    }
+    
+    int coach = seat.coach - 1;
+    int index = seat.seat - 1;
+    coaches[coach].words[index / 64].fetch_and(~(1ULL << (index % 64)), std::memory_order_acq_rel);
+    
+    uint64_t bit = 1ULL << (coach % 64);
+    summaryFor(layout.berthAt(seat.seat), coach).fetch_or(bit, std::memory_order_acq_rel);
+    
+    // Parties that now fit in this seat's bay, alone or with a neighbour.
+    // A bit missed in a race only costs placement; allocate still finds
+    // the seats.
+    uint64_t free0 = ~coaches[coach].words[0].load(std::memory_order_acquire);
+    uint64_t free1 = ~coaches[coach].words[1].load(std::memory_order_acquire);
+    int bay = std::min(index / layout.baySeats, bayCount - 1);
+    int inBay = freeInBay(free0, free1, bay);
+    int inPair = inBay + std::max(bay > 0 ? freeInBay(free0, free1, bay - 1) : 0,
+                                  bay + 1 < bayCount ? freeInBay(free0, free1, bay + 1) : 0);
+    for (int count = 2; count <= std::min(inPair, MAX_GROUP_SIZE); count++) {
+        int slot = (count - 2) * summaryWords + coach / 64;
+        if (count <= inBay && !(bayFitSummary[slot].load(std::memory_order_relaxed) & bit)) {
+            bayFitSummary[slot].fetch_or(bit, std::memory_order_acq_rel);
+        }
+        if (bayCount > 1 && !(pairFitSummary[slot].load(std::memory_order_relaxed) & bit)) {
+            pairFitSummary[slot].fetch_or(bit, std::memory_order_acq_rel);
+        }
+    }
+    
+    int hint = firstOpenCoach.load(std::memory_order_relaxed);
+    while (hint > coach && !firstOpenCoach.compare_exchange_weak(hint, coach, std::memory_order_relaxed)) {
+    }
+}
+
+int SeatMap::getCoachCount() const { return coachCount; }
+int SeatMap::getSeatsPerCoach() const { return layout.seatsPerCoach; }
+int SeatMap::getLegCount() const { return legCount; }
+const CoachLayout& SeatMap::getLayout() const { return layout; }
+
+int SeatMap::countFreeSeats() const {
+    int free = 0;
+    for (int c = 0; c < coachCount; c++) {
+        for (int w = 0; w < 2; w++) {
+            uint64_t bits = ~coaches[c].words[w].load(std::memory_order_relaxed) & seatMask[w];
+            free += __builtin_popcountll(bits);
+        }
+    }
+    return free;
+}
+
+void SeatMap::snapshotCoach(int coach, int fromStop, int toStop, uint8_t* bytes) const {
+    uint64_t legs = legMasks ? legRange(fromStop, toStop) : 0;
+    int byteCount = (layout.seatsPerCoach + 7) / 8;
+    
+    for (int w = 0; w * 64 < layout.seatsPerCoach; w++) {
+        uint64_t taken = coaches[coach].words[w].load(std::memory_order_relaxed) & seatMask[w];
+        if (legMasks) {
+            // Seats sold only on other legs are free for this journey
+            taken &= ~partialSeats(coach, w, legs);
+        }
+        for (int b = 0; b < 8 && w * 8 + b < byteCount; b++) {
+            bytes[w * 8 + b] = static_cast<uint8_t>(taken >> (b * 8));
+        }
+    }
+}
+
+SeatMapRegistry::SeatMapRegistry() {}
+
+SeatMapRegistry* SeatMapRegistry::getInstance() {
+    static SeatMapRegistry instance;
+    return &instance;
+}
+
+const CoachLayout& SeatMapRegistry::layoutFor(const std::string& classCode) {
+    TravelClass travelClass;
+    if (!parseTravelClass(classCode, travelClass)) {
+        travelClass = TravelClass::Sleeper;
+    }
+    return coachLayout(travelClass);
+}
+
+SeatMapRegistry::Shard& SeatMapRegistry::shardFor(const std::string& key) {
+    return shards[std::hash<std::string>()(key) % SHARD_COUNT];
+}
+
+void SeatMapRegistry::seedOccupancy(SeatMap& map, int totalSeats, int availableSeats, size_t seed) {
+    int perCoach = map.getSeatsPerCoach();
+    
+    // Seats past the class size in the last coach do not exist
+    for (int index = totalSeats; index < map.getCoachCount() * perCoach; index++) {
+        map.occupy({index / perCoach + 1, index % perCoach + 1});
+    }
+    
+    // Seats sold before the train was loaded, scattered the same way every run
+    std::vector<int> order(totalSeats);
+    std::iota(order.begin(), order.end(), 0);
+    std::mt19937 gen(static_cast<uint32_t>(seed));
+    
+    int taken = totalSeats - availableSeats;
+    for (int i = 0; i < taken; i++) {
+        std::uniform_int_distribution<int> pick(i, totalSeats - 1);
+        std::swap(order[i], order[pick(gen)]);
+        map.occupy({order[i] / perCoach + 1, order[i] % perCoach + 1});
+    }
+}
+
+std::string SeatMapRegistry::mapKey(const Train& train, const std::string& journeyDate,
+                                    const std::string& classCode) {
+    return train.getTrainNumber() + "|" + journeyDate + "|" + classCode;
+}
+
+std::unique_ptr<SeatMap> SeatMapRegistry::buildMap(const Train& train, const std::string& key,
+                                                   const std::string& classCode) {
+    const TrainAvailability* seed = nullptr;
+    for (const auto& avail : train.getAvailabilityRef()) {
+        if (avail.classCode == classCode) {
+            seed = &avail;
+            break;
+        }
+    }
+    if (!seed || seed->totalSeats <= 0) {
+        return nullptr;
+    }
+    
+    // Same starting point as the class's inventory counter
+    int totalSeats = seed->totalSeats;
+    int availableSeats = std::min(std::max(seed->availableSeats, 0), totalSeats);
+    const CoachLayout& layout = layoutFor(classCode);
+    int coachCount = (totalSeats + layout.seatsPerCoach - 1) / layout.seatsPerCoach;
+    
+    std::unique_ptr<SeatMap> map(new SeatMap(coachCount, layout, train.getLegCount()));
+    seedOccupancy(*map, totalSeats, availableSeats, std::hash<std::string>()(key));
+    return map;
+}
+
+SeatMap* SeatMapRegistry::getMap(const Train& train, const std::string& journeyDate,
+                                 const std::string& classCode) {
+    SeatMap* existing = findMap(train, journeyDate, classCode);
+    if (existing) {
+        return existing;
+    }
+    
+    std::string key = mapKey(train, journeyDate, classCode);
+    std::unique_ptr<SeatMap> map = buildMap(train, key, classCode);
+    if (!map) {
+        return nullptr;
+    }
+    
+    Shard& shard = shardFor(key);
+    std::unique_lock<std::shared_mutex> lock(shard.mutex);
+    auto& slot = shard.maps[key];
+    if (!slot) {
+        slot = std::move(map);
+    }
+    return slot.get();
+}
+
+SeatMap* SeatMapRegistry::findMap(const Train& train, const std::string& journeyDate,
+                                  const std::string& classCode) {
+    std::string key = mapKey(train, journeyDate, classCode);
+    Shard& shard = shardFor(key);
+    std::shared_lock<std::shared_mutex> lock(shard.mutex);
+    auto it = shard.maps.find(key);
+    return it != shard.maps.end() ? it->second.get() : nullptr;
+}
+
+std::unique_ptr<SeatMap> SeatMapRegistry::previewMap(const Train& train, const std::string& journeyDate,
+                                                     const std::string& classCode) {
+    return buildMap(train, mapKey(train, journeyDate, classCode), classCode);
+}
+
+void SeatMapRegistry::reserve(size_t additionalMaps) {
+    size_t perShard = additionalMaps / SHARD_COUNT + 1;
+    for (auto& shard : shards) {
+        std::unique_lock<std::shared_mutex> lock(shard.mutex);
+        shard.maps.reserve(shard.maps.size() + perShard);
+    }
+}
@@ -0,0 +1,213 @@
+#include "utils/SeatRebalancer.h"
+#include "utils/Config.h"
+#include "utils/DataStore.h"
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+
+namespace {
+
+std::string mapKeyOf(const BookingEvent& event) {
+    return std::string(event.trainNumber) + "|" + event.journeyDate + "|" + event.classCode;
+}
+
+// Berths are labelled "B3-41"; RAC and waitlist numbers have no dash
+bool holdsSeats(const BookingEvent& event) {
+    if (std::string(event.status) != "Confirmed") {
+        return false;
+    }
+    for (uint8_t i = 0; i < event.passengerCount; i++) {
+        const BookingEvent::PassengerState& passenger = event.passengers[i];
+        if (!passenger.cancelled && std::string(passenger.seat).find('-') != std::string::npos) {
+            return true;
+        }
+    }
+    return false;
+}
+
+}
+
+SeatRebalancer::SeatRebalancer() : stopping(false), moves(0) {
+    Config* config = Config::getInstance();
+    sliceMicros = std::max(50, config->getInt("/rebalancer/sliceMicros", 500));
+    pauseMillis = std::max(1, config->getInt("/rebalancer/pauseMillis", 20));
+}
+
+SeatRebalancer::~SeatRebalancer() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    wake.notify_all();
+    if (worker.joinable()) {
+        worker.join();
+    }
+}
+
+SeatRebalancer* SeatRebalancer::getInstance() {
+    static SeatRebalancer instance;
+    return &instance;
+}
+
+void SeatRebalancer::setMoveHandler(MoveHandler handler) {
+    std::lock_guard<std::mutex> lock(mutex);
+    moveHandler = std::move(handler);
+}
+
+void SeatRebalancer::start(const std::string& chartedThrough) {
+    if (!Config::getInstance()->getBool("/rebalancer/enabled", false)) {
+        return;
+    }
+    
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (worker.joinable()) {
+            return;
+        }
+        this->chartedThrough = chartedThrough;
+        worker = std::thread(&SeatRebalancer::run, this);
+    }
+    
+    EventBus::getInstance()->subscribe(
+        "seat-rebalancer",
+        [this](const BookingEvent& event) { apply(event); },
+        [this](uint64_t) { rebuild(true); }
+    );
+    
+    // Bookings made before the subscription; their maps wait for a release
+    rebuild(false);
+}
+
+void SeatRebalancer::markDirty(const std::string& mapKey) {
+    if (dirtySet.insert(mapKey).second) {
+        dirtyMaps.push_back(mapKey);
+        wake.notify_one();
+    }
+}
+
+void SeatRebalancer::apply(const BookingEvent& event) {
+    std::string journeyDate(event.journeyDate);
+    std::string mapKey = mapKeyOf(event);
+    
+    std::lock_guard<std::mutex> lock(mutex);
+    if (journeyDate <= chartedThrough) {
+        return;
+    }
+    
+    switch (event.type) {
+        case BookingEventType::BookingCreated:
+        case BookingEventType::BookingUpdated:
+            if (holdsSeats(event)) {
+                bookingsByMap[mapKey].insert(event.bookingId);
+            } else {
+                bookingsByMap[mapKey].erase(event.bookingId);
+            }
+            break;
+        case BookingEventType::BookingCancelled:
+            bookingsByMap[mapKey].erase(event.bookingId);
+            markDirty(mapKey);
+            break;
+        case BookingEventType::SeatsReleased:
+            markDirty(mapKey);
+            break;
+        default:
+            break;
+    }
+}
+
+void SeatRebalancer::rebuild(bool revisitAll) {
+    // At startup, and after the consumer lost events: one pass over the
+    // store, then every map is looked at again if releases may be missed
+    std::vector<BookingEvent> snapshots;
+    DataStore::getInstance()->forEachBooking([&snapshots](const Booking& booking) {
+        snapshots.push_back(BookingEvent::forBooking(BookingEventType::BookingUpdated, booking));
+    });
+    
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        bookingsByMap.clear();
+    }
+    for (const auto& snapshot : snapshots) {
+        apply(snapshot);
+    }
+    
+    if (!revisitAll) {
+        return;
+    }
+    std::lock_guard<std::mutex> lock(mutex);
+    for (const auto& entry : bookingsByMap) {
+        markDirty(entry.first);
+    }
+}
+
+void SeatRebalancer::closeThrough(const std::string& journeyDate) {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (journeyDate <= chartedThrough) {
+        return;
+    }
+    chartedThrough = journeyDate;
+    
+    // Keys start with the train number, so match on the date field
+    for (auto it = bookingsByMap.begin(); it != bookingsByMap.end();) {
+        size_t bar = it->first.find('|');
+        if (it->first.compare(bar + 1, journeyDate.size(), journeyDate) <= 0) {
+            it = bookingsByMap.erase(it);
+        } else {
+            ++it;
+        }
+    }
+}
+
+void SeatRebalancer::run() {
+    using Clock = std::chrono::steady_clock;
+    
+    std::unique_lock<std::mutex> lock(mutex);
+    while (!stopping) {
+        if (dirtyMaps.empty() || !moveHandler) {
+            wake.wait(lock);
+            continue;
+        }
+        
+        std::string mapKey = dirtyMaps.front();
+        dirtyMaps.pop_front();
+        dirtySet.erase(mapKey);
+        
+        auto it = bookingsByMap.find(mapKey);
+        if (it == bookingsByMap.end()) {
+            continue;
+        }
+        std::vector<std::string> bookingIds(it->second.begin(), it->second.end());
+        MoveHandler handler = moveHandler;
+        lock.unlock();
+        
+        // One booking at a time; past the slice budget, yield the CPU and
+        // the booking lock to request threads before the next one
+        int moved = 0;
+        Clock::time_point sliceStart = Clock::now();
+        for (const auto& bookingId : bookingIds) {
+            if (handler(bookingId)) {
+                moved++;
+            }
+            if (Clock::now() - sliceStart >= std::chrono::microseconds(sliceMicros)) {
+                lock.lock();
+                wake.wait_for(lock, std::chrono::milliseconds(pauseMillis), [this] { return stopping; });
+                bool stop = stopping;
+                lock.unlock();
+                if (stop) {
+                    return;
+                }
+                sliceStart = Clock::now();
+            }
+        }
+        
+        if (moved > 0) {
+            moves.fetch_add(moved, std::memory_order_relaxed);
+            std::cout << "Rebalanced " << moved << " booking(s) on " << mapKey << std::endl;
+        }
+        lock.lock();
+    }
+}
+
+uint64_t SeatRebalancer::getMoveCount() const {
+    return moves.load(std::memory_order_relaxed);
+}
@@ -0,0 +1,74 @@
+#include "utils/TimerWheel.h"
+
+TimerWheel::TimerWheel(uint64_t startTick) : currentTick(startTick), pending(0) {}
+
+void TimerWheel::place(const Entry& entry) {
+    uint64_t delta = entry.expiryTick - currentTick;
+    
+    // Pick the lowest level whose span still covers the remaining delay
+    int level = 0;
+    while (level < LEVELS - 1 && delta >= (1ULL << (SLOT_BITS * (level + 1)))) {
+        level++;
+    }
+    
+    uint64_t slot = (entry.expiryTick >> (SLOT_BITS * level)) & SLOT_MASK;
+    slots[level][slot].push_back(entry);
+}
+
+void TimerWheel::cascade(int level) {
+    uint64_t slot = (currentTick >> (SLOT_BITS * level)) & SLOT_MASK;
+    
+    std::vector<Entry> entries;
+    entries.swap(slots[level][slot]);
+    for (const auto& entry : entries) {
+        place(entry);
+    }
+}
+
+void TimerWheel::schedule(uint64_t id, uint64_t expiryTick) {
+    // Already due timers fire on the next tick
+    if (expiryTick <= currentTick) {
+        expiryTick = currentTick + 1;
+    }
+    
+    // Clamp delays beyond the wheel span to the outermost level
+    uint64_t span = 1ULL << (SLOT_BITS * LEVELS);
+    if (expiryTick - currentTick >= span) {
+        expiryTick = currentTick + span - 1;
+    }
+    
+    place(Entry{id, expiryTick});
+    pending++;
+}
+
+void TimerWheel::advance(uint64_t nowTick, std::vector<uint64_t>& expired) {
+    while (currentTick < nowTick) {
+        currentTick++;
+        
+        // Refill lower levels when a higher level slot comes due
+        for (int level = 1; level < LEVELS; level++) {
+            if ((currentTick & ((1ULL << (SLOT_BITS * level)) - 1)) != 0) break;
+            cascade(level);
+        }
+        
+        std::vector<Entry>& due = slots[0][currentTick & SLOT_MASK];
+        for (const auto& entry : due) {
+            expired.push_back(entry.id);
+        }
+        pending -= due.size();
+        due.clear();
+        
+        if (pending == 0) {
+            // Nothing left to fire; jump straight to the target tick
+            currentTick = nowTick;
+        }
+    }
+}
+
+uint64_t TimerWheel::getCurrentTick() const {
+    return currentTick;
+}
+
+size_t TimerWheel::size() const {
+    return pending;
+}
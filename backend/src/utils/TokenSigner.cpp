@@ -0,0 +1,156 @@
+#include "utils/TokenSigner.h"
+#include "utils/Config.h"
+#include "utils/Crypto.h"
+#include <algorithm>
+#include <iostream>
+
+namespace {
+
+const char* const TOKEN_PREFIX = "st.";
+const char* const SAMPLE_SECRET = "your-secret-key-change-in-production";
+
+// 32 bits from eight hex digits of the MAC
+uint32_t hexWord(const std::string& hex, size_t offset) {
+    uint32_t word = 0;
+    for (size_t i = offset; i < offset + 8; i++) {
+        char c = hex[i];
+        word = (word << 4) | static_cast<uint32_t>(c <= '9' ? c - '0' : c - 'a' + 10);
+    }
+    return word;
+}
+
+}
+
+TokenSigner::TokenSigner() {
+    Config* config = Config::getInstance();
+    enabled = config->getBool("/security/statelessTokens", false);
+    ttlSeconds = std::max(1, config->getInt("/security/tokenExpiry", 86400));
+    std::string secret = config->getString("/security/jwtSecret", "");
+    
+    if (enabled && (secret.empty() || secret == SAMPLE_SECRET)) {
+        // Tokens then only verify within this process
+        std::cerr << "security.jwtSecret is not set; stateless tokens use a per-process key" << std::endl;
+        secret = Crypto::randomBytes(32);
+    }
+    hmac.reset(new Crypto::HmacSha256(secret));
+    
+    // Power of two for masking
+    size_t slots = 1024;
+    size_t wanted = static_cast<size_t>(std::max(1, config->getInt("/security/maxRevokedTokens", 65536)));
+    while (slots < wanted) {
+        slots <<= 1;
+    }
+    revokedMask = slots - 1;
+    revoked.reset(new std::atomic<uint64_t>[slots]);
+    for (size_t i = 0; i < slots; i++) {
+        revoked[i].store(0, std::memory_order_relaxed);
+    }
+}
+
+TokenSigner* TokenSigner::getInstance() {
+    static TokenSigner instance;
+    return &instance;
+}
+
+bool TokenSigner::isEnabled() const {
+    return enabled;
+}
+
+bool TokenSigner::isSignedToken(const std::string& token) {
+    return token.compare(0, 3, TOKEN_PREFIX) == 0;
+}
+
+std::string TokenSigner::sign(const std::string& userId, std::time_t expiresAt) const {
+    return hmac->hex(userId + "." + std::to_string(expiresAt));
+}
+
+std::string TokenSigner::issue(const std::string& userId) {
+    std::time_t expiresAt = std::time(nullptr) + ttlSeconds;
+    return TOKEN_PREFIX + userId + "." + std::to_string(expiresAt) + "." + sign(userId, expiresAt);
+}
+
+bool TokenSigner::parse(const std::string& token, std::string& userId,
+                        std::time_t& expiresAt, std::string& mac) const {
+    if (!isSignedToken(token)) {
+        return false;
+    }
+    size_t macDot = token.rfind('.');
+    size_t expiryDot = macDot == std::string::npos ? macDot : token.rfind('.', macDot - 1);
+    if (expiryDot == std::string::npos || expiryDot < 3 || macDot - expiryDot < 2 ||
+        macDot - expiryDot > 11 || token.size() - macDot - 1 != 64) {
+        return false;
+    }
+    
+    expiresAt = 0;
+    for (size_t i = expiryDot + 1; i < macDot; i++) {
+        if (token[i] < '0' || token[i] > '9') return false;
+        expiresAt = expiresAt * 10 + (token[i] - '0');
+    }
+    userId = token.substr(3, expiryDot - 3);
+    mac = token.substr(macDot + 1);
+    return !userId.empty();
+}
+
+bool TokenSigner::isRevoked(const std::string& mac, std::time_t now) const {
+    uint32_t fingerprint = hexWord(mac, 0) | 1; // Zero marks an empty slot
+    size_t slot = hexWord(mac, 8) & revokedMask;
+    
+    for (int probe = 0; probe < MAX_PROBES; probe++) {
+        uint64_t entry = revoked[(slot + probe) & revokedMask].load(std::memory_order_acquire);
+        if (entry == 0) {
+            return false;
+        }
+        if (static_cast<uint32_t>(entry >> 32) == fingerprint &&
+            static_cast<std::time_t>(static_cast<uint32_t>(entry)) > now) {
+            return true;
+        }
+    }
+    return false;
+}
+
+bool TokenSigner::verify(const std::string& token, std::string& userId) const {
+    std::time_t expiresAt;
+    std::string mac;
+    if (!parse(token, userId, expiresAt, mac)) {
+        return false;
+    }
+    
+    std::time_t now = std::time(nullptr);
+    if (expiresAt <= now || !Crypto::constantTimeEquals(mac, sign(userId, expiresAt))) {
+        return false;
+    }
+    return !isRevoked(mac, now);
+}
+
+bool TokenSigner::revoke(const std::string& token) {
+    std::string userId;
+    std::string mac;
+    std::time_t expiresAt;
+    std::time_t now = std::time(nullptr);
+    if (!parse(token, userId, expiresAt, mac) || expiresAt <= now ||
+        !Crypto::constantTimeEquals(mac, sign(userId, expiresAt))) {
+        return false;
+    }
+    if (isRevoked(mac, now)) {
+        return true; // Logged out already
+    }
+    
+    uint64_t entry = static_cast<uint64_t>(hexWord(mac, 0) | 1) << 32 |
+                     (static_cast<uint64_t>(expiresAt) & 0xffffffffULL);
+    size_t slot = hexWord(mac, 8) & revokedMask;
+    
+    // Take an empty slot, or one whose token has expired anyway
+    for (int probe = 0; probe < MAX_PROBES; probe++) {
+        std::atomic<uint64_t>& cell = revoked[(slot + probe) & revokedMask];
+        uint64_t current = cell.load(std::memory_order_acquire);
+        while (current == 0 || static_cast<std::time_t>(static_cast<uint32_t>(current)) <= now) {
+            if (cell.compare_exchange_weak(current, entry, std::memory_order_acq_rel,
+                                           std::memory_order_acquire)) {
+                return true;
+            }
+        }
+    }
+    
+    std::cerr << "Revocation table full; token stays valid until it expires" << std::endl;
+    return false;
+}
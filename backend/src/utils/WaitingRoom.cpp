@@ -0,0 +1,142 @@
+#include "utils/WaitingRoom.h"
+#include "utils/Config.h"
+#include "utils/Crypto.h"
+#include <algorithm>
+#include <cmath>
+
+WaitingRoom::WaitingRoom() 
+    : lastIssued(0), admittedThrough(0), admitCredit(0.0),
+      lastAdvance(std::chrono::steady_clock::now()) {
+    Config* config = Config::getInstance();
+    enabled = config->getBool("/waitingRoom/enabled", false);
+    admitRatePerSecond = config->getDouble("/waitingRoom/admitRatePerSecond", 50.0);
+    admissionWindowSeconds = config->getInt("/waitingRoom/admissionWindowSeconds", 120);
+    
+    if (admitRatePerSecond <= 0.0) admitRatePerSecond = 1.0;
+    if (admissionWindowSeconds <= 0) admissionWindowSeconds = 1;
+    
+    // Tickets only need to verify within this process
+    secret = Crypto::randomBytes(32);
+    
+    // Two tickets sharing a slot are more than a window apart, so at most
+    // one of them can still be admitted
+    spentCapacity = static_cast<size_t>(admitRatePerSecond * admissionWindowSeconds) + 1;
+    spentBookings.reset(new std::atomic<uint64_t>[spentCapacity]);
+    spentHolds.reset(new std::atomic<uint64_t>[spentCapacity]);
+    for (size_t i = 0; i < spentCapacity; i++) {
+        spentBookings[i].store(0, std::memory_order_relaxed);
+        spentHolds[i].store(0, std::memory_order_relaxed);
+    }
+}
+
+WaitingRoom* WaitingRoom::getInstance() {
+    static WaitingRoom instance;
+    return &instance;
+}
+
+bool WaitingRoom::isEnabled() const {
+    return enabled;
+}
+
+bool WaitingRoom::guards(const std::string& method, const std::string& path) const {
+    return enabled && method == "POST" && (path == "/api/bookings" || path == "/api/holds");
+}
+
+std::string WaitingRoom::sign(uint64_t number) const {
+    // 64 bits of MAC is plenty for a ticket that lives for minutes
+    return Crypto::hmacSha256Hex(secret, std::to_string(number)).substr(0, 16);
+}
+
+void WaitingRoom::advance() {
+    std::unique_lock<std::mutex> lock(advanceMutex, std::try_to_lock);
+    if (!lock.owns_lock()) {
+        return; // Another thread is advancing right now
+    }
+    
+    auto now = std::chrono::steady_clock::now();
+    double elapsed = std::chrono::duration<double>(now - lastAdvance).count();
+    lastAdvance = now;
+    
+    admitCredit += elapsed * admitRatePerSecond;
+    double whole = std::floor(admitCredit);
+    admitCredit -= whole;
+    
+    // Idle time does not bank admissions beyond a one-second burst
+    uint64_t burst = static_cast<uint64_t>(std::max(1.0, admitRatePerSecond));
+    uint64_t ceiling = lastIssued.load() + burst;
+    uint64_t next = admittedThrough.load() + static_cast<uint64_t>(whole);
+    
+    admittedThrough.store(std::min(next, ceiling));
+}
+
+QueueTicket WaitingRoom::join() {
+    QueueTicket ticket;
+    ticket.number = lastIssued.fetch_add(1) + 1;
+    ticket.token = std::to_string(ticket.number) + "." + sign(ticket.number);
+    return ticket;
+}
+
+bool WaitingRoom::parseToken(const std::string& token, uint64_t& number) const {
+    size_t dot = token.find('.');
+    if (dot == std::string::npos || dot == 0 || dot > 20) {
+        return false;
+    }
+    
+    number = 0;
+    for (size_t i = 0; i < dot; i++) {
+        if (token[i] < '0' || token[i] > '9') return false;
+        number = number * 10 + static_cast<uint64_t>(token[i] - '0');
+    }
+    
+    return Crypto::constantTimeEquals(token.substr(dot + 1), sign(number));
+}
+
+uint64_t WaitingRoom::getPosition(uint64_t number) {
+    advance();
+    uint64_t admitted = admittedThrough.load();
+    return number > admitted ? number - admitted : 0;
+}
+
+bool WaitingRoom::isAdmitted(const std::string& token, uint64_t& position, uint64_t& number) {
+    if (!parseToken(token, number)) {
+        position = 0;
+        return false;
+    }
+    
+    position = getPosition(number);
+    if (position > 0) {
+        return false;
+    }
+    
+    // Admission lapses once the window's worth of later tickets got in
+    uint64_t window = static_cast<uint64_t>(admitRatePerSecond * admissionWindowSeconds);
+    return number + window > admittedThrough.load();
+}
+
+std::atomic<uint64_t>& WaitingRoom::spentSlot(const std::string& path, uint64_t number) {
+    std::atomic<uint64_t>* ring = path == "/api/holds" ? spentHolds.get() : spentBookings.get();
+    return ring[number % spentCapacity];
+}
+
+bool WaitingRoom::spend(const std::string& path, uint64_t number) {
+    std::atomic<uint64_t>& slot = spentSlot(path, number);
+    uint64_t seen = slot.load(std::memory_order_acquire);
+    
+    // A slot left by an older ticket is free; this ticket or a newer one
+    // means it is spent
+    while (seen < number) {
+        if (slot.compare_exchange_weak(seen, number, std::memory_order_acq_rel)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+void WaitingRoom::restore(const std::string& path, uint64_t number) {
+    uint64_t expected = number;
+    spentSlot(path, number).compare_exchange_strong(expected, 0, std::memory_order_acq_rel);
+}
+
+int WaitingRoom::estimateWaitSeconds(uint64_t position) const {
+    return static_cast<int>(std::ceil(position / admitRatePerSecond));
+}
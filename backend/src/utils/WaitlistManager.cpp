@@ -0,0 +1,254 @@
+#include "utils/WaitlistManager.h"
+#include "utils/EventBus.h"
+#include <algorithm>
+
+WaitlistManager::WaitlistManager() {}
+
+WaitlistManager* WaitlistManager::getInstance() {
+    static WaitlistManager instance;
+    return &instance;
+}
+
+void WaitlistManager::setPromotionHandler(PromotionHandler handler) {
+    promotionHandler = handler;
+}
+
+void WaitlistManager::setNotifyHandler(NotifyHandler handler) {
+    notifyHandler = handler;
+}
+
+int WaitlistManager::racCapacityFor(const std::string& classCode, int totalSeats) {
+    // Side-lower berths are shared in RAC; seating classes have no RAC
+    if (classCode == "SL" || classCode == "3A" || classCode == "2A") {
+        return totalSeats / 8;
+    }
+    return 0;
+}
+
+WaitlistManager::Queues* WaitlistManager::getQueues(const std::string& trainNumber,
+                                                    const std::string& journeyDate,
+                                                    const std::string& classCode,
+                                                    InventoryCounter* counter) {
+    std::string key = trainNumber + "|" + journeyDate + "|" + classCode;
+    Shard& shard = shards[std::hash<std::string>()(key) % SHARD_COUNT];
+    
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    auto& slot = shard.queues[key];
+    if (!slot) {
+        slot.reset(new Queues());
+        slot->counter = counter;
+        slot->racCapacity = racCapacityFor(classCode, counter->totalSeats);
+        slot->racOccupied = 0;
+        slot->waitlistOccupied = 0;
+        slot->bankedSeats = 0;
+        slot->nextRacNumber = 1;
+        // Continue numbering after the waitlist the train was loaded with
+        slot->nextWaitlistNumber = counter->initialWaitlist + 1;
+    }
+    return slot.get();
+}
+
+void WaitlistManager::reserve(size_t additionalClasses) {
+    size_t perShard = additionalClasses / SHARD_COUNT + 1;
+    for (auto& shard : shards) {
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        shard.queues.reserve(shard.queues.size() + perShard);
+    }
+}
+
+void WaitlistManager::prepare(const std::string& trainNumber, const std::string& journeyDate,
+                              const std::string& classCode, InventoryCounter* counter) {
+    if (counter) {
+        getQueues(trainNumber, journeyDate, classCode, counter);
+    }
+}
+
+void WaitlistManager::promoteLocked(Queues& queues, const std::string& trainNumber,
+                                    const std::string& journeyDate,
+                                    const std::string& classCode,
+                                    std::vector<WaitlistPromotion>& applied) {
+    auto promote = [&](const Entry& entry, WaitlistTier tier, int number) {
+        WaitlistPromotion promotion{entry.bookingId, trainNumber, journeyDate, classCode, tier, number};
+        if (promotionHandler && !promotionHandler(promotion)) {
+            return false;
+        }
+        applied.push_back(promotion);
+        return true;
+    };
+    
+    bool progress = true;
+    bool stalled = false;
+    while (progress && !stalled) {
+        progress = false;
+        
+        // RAC heads move to confirmed berths first
+        while (!stalled && !queues.rac.empty() && queues.rac.front().seats <= queues.bankedSeats) {
+            const Entry& entry = queues.rac.front();
+            if (!promote(entry, WaitlistTier::Confirmed, 0)) {
+                stalled = true;
+                break;
+            }
+            queues.bankedSeats -= entry.seats;
+            queues.racOccupied -= entry.seats;
+            queues.rac.pop_front();
+            progress = true;
+        }
+        
+        // With RAC drained, the waitlist head can be confirmed directly
+        while (!stalled && queues.rac.empty() && !queues.waitlist.empty() &&
+               queues.waitlist.front().seats <= queues.bankedSeats) {
+            const Entry& entry = queues.waitlist.front();
+            if (!promote(entry, WaitlistTier::Confirmed, 0)) {
+                stalled = true;
+                break;
+            }
+            queues.bankedSeats -= entry.seats;
+            queues.waitlistOccupied -= entry.seats;
+            queues.waitlist.pop_front();
+            progress = true;
+        }
+        
+        // A head that could not be seated keeps its place and the seats
+        // stay banked; the next release or cancellation retries it
+        if (stalled) {
+            break;
+        }
+        
+        // Freed RAC places go to the head of the waitlist
+        while (!queues.waitlist.empty() &&
+               queues.racOccupied + queues.waitlist.front().seats <= queues.racCapacity) {
+            Entry entry = queues.waitlist.front();
+            queues.waitlist.pop_front();
+            queues.waitlistOccupied -= entry.seats;
+            
+            entry.number = queues.nextRacNumber;
+            queues.nextRacNumber += entry.seats;
+            queues.racOccupied += entry.seats;
+            queues.rac.push_back(entry);
+            promote(entry, WaitlistTier::RAC, entry.number);
+            progress = true;
+        }
+    }
+    
+    // Nobody is waiting: the rest goes back to open inventory
+    if (queues.rac.empty() && queues.waitlist.empty() && queues.bankedSeats > 0) {
+        SeatInventory::release(queues.counter, queues.bankedSeats);
+        queues.bankedSeats = 0;
+    }
+}
+
+bool WaitlistManager::enqueue(const std::string& trainNumber, const std::string& journeyDate,
+                              const std::string& classCode, InventoryCounter* counter,
+                              const std::string& bookingId, int seats, WaitlistTicket& ticket,
+                              const std::function<void(const WaitlistTicket&)>& onQueued) {
+    if (!counter || seats <= 0) {
+        return false;
+    }
+    
+    Queues* queues = getQueues(trainNumber, journeyDate, classCode, counter);
+    std::lock_guard<std::mutex> lock(queues->mutex);
+    
+    // Seats may have been released since the caller's attempt
+    if (SeatInventory::tryReserve(counter, seats)) {
+        ticket = {WaitlistTier::Confirmed, 0};
+        return true;
+    }
+    
+    Entry entry{bookingId, seats, 0};
+    
+    if (queues->waitlist.empty() && queues->racOccupied + seats <= queues->racCapacity) {
+        entry.number = queues->nextRacNumber;
+        queues->nextRacNumber += seats;
+        queues->racOccupied += seats;
+        queues->rac.push_back(entry);
+        ticket = {WaitlistTier::RAC, entry.number};
+    } else if (queues->waitlistOccupied + seats <= MAX_WAITLIST) {
+        entry.number = queues->nextWaitlistNumber;
+        queues->nextWaitlistNumber += seats;
+        queues->waitlistOccupied += seats;
+        queues->waitlist.push_back(entry);
+        ticket = {WaitlistTier::Waitlisted, entry.number};
+    } else {
+        return false;
+    }
+    
+    onQueued(ticket);
+    return true;
+}
+
+void WaitlistManager::notifyPromoted(const std::vector<WaitlistPromotion>& applied) {
+    if (notifyHandler) {
+        for (const auto& promotion : applied) {
+            notifyHandler(promotion);
+        }
+    }
+}
+
+void WaitlistManager::releaseSeats(const std::string& trainNumber, const std::string& journeyDate,
+                                   const std::string& classCode, InventoryCounter* counter,
+                                   int seats, Quota quota) {
+    if (!counter || seats <= 0) {
+        return;
+    }
+    
+    if (quota != Quota::General) {
+        SeatInventory::release(counter, seats, quota);
+    } else {
+        Queues* queues = getQueues(trainNumber, journeyDate, classCode, counter);
+        std::vector<WaitlistPromotion> applied;
+        {
+            std::lock_guard<std::mutex> lock(queues->mutex);
+            queues->bankedSeats += seats;
+            promoteLocked(*queues, trainNumber, journeyDate, classCode, applied);
+        }
+        notifyPromoted(applied);
+    }
+    
+    EventBus::getInstance()->publish(BookingEvent::forInventory(
+        BookingEventType::SeatsReleased, trainNumber, journeyDate, classCode, seats,
+        counter->general().load(std::memory_order_relaxed)));
+}
+
+int WaitlistManager::spillQuotas(const std::string& trainNumber, const std::string& journeyDate,
+                                 const std::string& classCode, InventoryCounter* counter) {
+    int spilled = SeatInventory::drainSpecialQuotas(counter);
+    releaseSeats(trainNumber, journeyDate, classCode, counter, spilled);
+    return spilled;
+}
+
+bool WaitlistManager::cancelQueued(const std::string& trainNumber, const std::string& journeyDate,
+                                   const std::string& classCode, InventoryCounter* counter,
+                                   const std::string& bookingId,
+                                   const std::function<void()>& onRemoved) {
+    if (!counter) {
+        return false;
+    }
+    
+    Queues* queues = getQueues(trainNumber, journeyDate, classCode, counter);
+    std::vector<WaitlistPromotion> applied;
+    {
+        std::lock_guard<std::mutex> lock(queues->mutex);
+        
+        auto matches = [&bookingId](const Entry& entry) { return entry.bookingId == bookingId; };
+        
+        auto racIt = std::find_if(queues->rac.begin(), queues->rac.end(), matches);
+        if (racIt != queues->rac.end()) {
+            queues->racOccupied -= racIt->seats;
+            queues->rac.erase(racIt);
+        } else {
+            auto wlIt = std::find_if(queues->waitlist.begin(), queues->waitlist.end(), matches);
+            if (wlIt == queues->waitlist.end()) {
+                return false; // Promoted or never queued
+            }
+            queues->waitlistOccupied -= wlIt->seats;
+            queues->waitlist.erase(wlIt);
+        }
+        
+        onRemoved();
+        
+        // A new head or a freed RAC place may now be promotable
+        promoteLocked(*queues, trainNumber, journeyDate, classCode, applied);
+    }
+    notifyPromoted(applied);
+    return true;
+}
@@ -0,0 +1,167 @@
+// Hammers one hot (train, date, class) counter from many threads with
+// SeatInventory::tryReserve and release, and checks it never sells more
+// seats than it holds. Threads keep the counter near empty so most
+// attempts race for the last seats. Every confirmed reservation is added
+// to a shared tally before anything is released, so the tally can only
+// exceed the class size if the counter oversold. Exits non-zero on any
+// oversell or if the counter does not return to full afterwards.
+//
+//   inventory_stress [--threads 8] [--seconds 2] [--seats 1000] [--seed 1]
+
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <vector>
+#include <random>
+#include <chrono>
+#include <thread>
+#include <atomic>
+#include <algorithm>
+#include "models/Train.h"
+#include "utils/DateUtils.h"
+#include "utils/SeatInventory.h"
+
+namespace {
+
+struct Options {
+    int threads = static_cast<int>(std::max(2u, std::thread::hardware_concurrency()));
+    double seconds = 2.0;
+    int seats = 1000;
+    unsigned seed = 1;
+};
+
+struct WorkerStats {
+    long attempts = 0;
+    long reserved = 0;
+    long refused = 0;
+};
+
+bool parseOptions(int argc, char* argv[], Options& options) {
+    for (int i = 1; i < argc; i++) {
+        std::string flag = argv[i];
+        if (i + 1 >= argc) {
+            std::cerr << "Missing value for " << flag << std::endl;
+            return false;
+        }
+        std::string value = argv[++i];
+        try {
+            if (flag == "--threads") options.threads = std::stoi(value);
+            else if (flag == "--seconds") options.seconds = std::stod(value);
+            else if (flag == "--seats") options.seats = std::stoi(value);
+            else if (flag == "--seed") options.seed = static_cast<unsigned>(std::stoul(value));
+            else {
+                std::cerr << "Unknown option " << flag << std::endl;
+                return false;
+            }
+        } catch (const std::exception&) {
+            std::cerr << "Invalid value for " << flag << ": " << value << std::endl;
+            return false;
+        }
+    }
+    
+    if (options.threads < 1 || options.seconds <= 0.0 || options.seats < 6) {
+        std::cerr << "threads and seconds must be positive, seats at least 6" << std::endl;
+        return false;
+    }
+    return true;
+}
+
+}
+
+int main(int argc, char* argv[]) {
+    Options options;
+    if (!parseOptions(argc, argv, options)) {
+        std::cerr << "Usage: inventory_stress [--threads 8] [--seconds 2] [--seats 1000] "
+                  << "[--seed 1]" << std::endl;
+        return 1;
+    }
+    
+    // The General quota of the class is the contended pool
+    Train train("00000", "Stress Express");
+    train.addAvailability(TrainAvailability("CC", options.seats, options.seats, 0.0));
+    InventoryCounter* counter = SeatInventory::getInstance()->getCounter(
+        train, DateUtils::formatDate(DateUtils::today() + 1), "CC");
+    const int capacity = counter->general().load();
+    
+    std::atomic<long> sold(0);
+    std::atomic<long> peakSold(0);
+    std::atomic<long> oversells(0);
+    std::atomic<bool> negativeSeen(false);
+    std::atomic<bool> running(true);
+    std::vector<WorkerStats> stats(static_cast<size_t>(options.threads));
+    std::vector<std::thread> workers;
+    
+    auto started = std::chrono::steady_clock::now();
+    for (int t = 0; t < options.threads; t++) {
+        workers.emplace_back([&, t]() {
+            std::mt19937 rng(options.seed * 7919u + static_cast<unsigned>(t));
+            std::uniform_int_distribution<int> party(1, 6);
+            std::vector<int> held;
+            WorkerStats& mine = stats[static_cast<size_t>(t)];
+            
+            while (running.load(std::memory_order_relaxed)) {
+                // Release about as often as reservations succeed, so the
+                // counter hovers near zero
+                if (!held.empty() && (rng() & 1)) {
+                    int seats = held.back();
+                    held.pop_back();
+                    sold.fetch_sub(seats);
+                    SeatInventory::release(counter, seats);
+                    continue;
+                }
+                
+                int seats = party(rng);
+                mine.attempts++;
+                if (!SeatInventory::tryReserve(counter, seats)) {
+                    mine.refused++;
+                    continue;
+                }
+                mine.reserved++;
+                held.push_back(seats);
+                
+                long now = sold.fetch_add(seats) + seats;
+                if (now > capacity) {
+                    oversells.fetch_add(1);
+                }
+                long peak = peakSold.load(std::memory_order_relaxed);
+                while (now > peak && !peakSold.compare_exchange_weak(peak, now)) {}
+                if (counter->general().load(std::memory_order_relaxed) < 0) {
+                    negativeSeen = true;
+                }
+            }
+            
+            for (int seats : held) {
+                sold.fetch_sub(seats);
+                SeatInventory::release(counter, seats);
+            }
+        });
+    }
+    
+    std::this_thread::sleep_for(std::chrono::duration<double>(options.seconds));
+    running = false;
+    for (auto& worker : workers) {
+        worker.join();
+    }
+    double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - started).count();
+    
+    WorkerStats total;
+    for (const auto& worker : stats) {
+        total.attempts += worker.attempts;
+        total.reserved += worker.reserved;
+        total.refused += worker.refused;
+    }
+    int remaining = counter->general().load();
+    bool ok = oversells.load() == 0 && !negativeSeen.load() && remaining == capacity;
+    
+    std::cout << std::fixed << std::setprecision(0);
+    std::cout << options.threads << " threads on one counter of " << capacity << " seats for "
+              << std::setprecision(2) << elapsed << " s" << std::setprecision(0) << std::endl;
+    std::cout << "Attempts:      " << total.attempts << " (" << total.attempts / elapsed << "/s)" << std::endl;
+    std::cout << "Reservations:  " << total.reserved << " (" << total.reserved / elapsed << "/s)" << std::endl;
+    std::cout << "Refused:       " << total.refused << " (counter could not cover the party)" << std::endl;
+    std::cout << "Peak sold:     " << peakSold.load() << " of " << capacity << std::endl;
+    std::cout << "Oversells:     " << oversells.load() << std::endl;
+    std::cout << "Seats at end:  " << remaining << " of " << capacity << std::endl;
+    std::cout << (ok ? "PASS" : "FAIL") << std::endl;
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,319 @@
+// Measures SeatMap allocations per second on a full rake (24 coaches by
+// default). Each round fills a map seat by seat until it refuses, then
+// releases everything, so every run covers the near-full scans as well as
+// the empty ones. Also times claiming the last free seats over and over,
+// party allocation, part-route segments on a multi-leg map and a fill
+// from several threads at once. Times include refused attempts. Checks
+// every fill seats exactly the rake with no seat given out twice, and
+// exits non-zero if one does not.
+//
+//   seat_map_benchmark [--class SL] [--coaches 24] [--rounds 200]
+//                      [--legs 8] [--threads 4] [--seed 1]
+
+#include <iostream>
+#include <iomanip>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <random>
+#include <chrono>
+#include <thread>
+#include <atomic>
+#include <algorithm>
+#include "models/Train.h"
+#include "utils/SeatMap.h"
+
+namespace {
+
+struct Options {
+    std::string classCode = "SL";
+    int coaches = 24;
+    int rounds = 200;
+    int legs = 8;
+    int threads = 4;
+    unsigned seed = 1;
+};
+
+struct Segment {
+    SeatRef seat;
+    int fromStop;
+    int toStop;
+};
+
+// A round of parties or segments ends after this many refusals in a row
+const int FULL_AFTER_FAILURES = 20;
+
+bool parseOptions(int argc, char* argv[], Options& options) {
+    for (int i = 1; i < argc; i++) {
+        std::string flag = argv[i];
+        if (i + 1 >= argc) {
+            std::cerr << "Missing value for " << flag << std::endl;
+            return false;
+        }
+        std::string value = argv[++i];
+        try {
+            if (flag == "--class") options.classCode = value;
+            else if (flag == "--coaches") options.coaches = std::stoi(value);
+            else if (flag == "--rounds") options.rounds = std::stoi(value);
+            else if (flag == "--legs") options.legs = std::stoi(value);
+            else if (flag == "--threads") options.threads = std::stoi(value);
+            else if (flag == "--seed") options.seed = static_cast<unsigned>(std::stoul(value));
+            else {
+                std::cerr << "Unknown option " << flag << std::endl;
+                return false;
+            }
+        } catch (const std::exception&) {
+            std::cerr << "Invalid value for " << flag << ": " << value << std::endl;
+            return false;
+        }
+    }
+    
+    TravelClass travelClass;
+    if (!parseTravelClass(options.classCode, travelClass)) {
+        std::cerr << "Unknown class " << options.classCode << std::endl;
+        return false;
+    }
+    if (options.coaches < 1 || options.rounds < 1 || options.threads < 1 ||
+        options.legs < 2 || options.legs > SeatMap::MAX_LEGS) {
+        std::cerr << "coaches, rounds and threads must be positive, legs 2 to "
+                  << SeatMap::MAX_LEGS << std::endl;
+        return false;
+    }
+    return true;
+}
+
+double secondsSince(std::chrono::steady_clock::time_point started) {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - started).count();
+}
+
+void report(const std::string& label, long allocations, double seconds, const std::string& note = "") {
+    std::cout << std::left << std::setw(16) << label << std::right
+              << std::setw(12) << static_cast<long>(allocations / seconds) << " allocations/s"
+              << std::setw(8) << std::setprecision(1) << seconds * 1e9 / allocations << " ns each";
+    if (!note.empty()) {
+        std::cout << "  " << note;
+    }
+    std::cout << std::endl;
+}
+
+// Marks each seat in taken; false if any was already marked
+bool markSeats(const std::vector<SeatRef>& seats, int seatsPerCoach, std::vector<char>& taken) {
+    bool distinct = true;
+    for (const auto& seat : seats) {
+        char& slot = taken[static_cast<size_t>(seat.coach - 1) * seatsPerCoach + seat.seat - 1];
+        if (slot) {
+            distinct = false;
+        }
+        slot = 1;
+    }
+    return distinct;
+}
+
+}
+
+int main(int argc, char* argv[]) {
+    Options options;
+    if (!parseOptions(argc, argv, options)) {
+        std::cerr << "Usage: seat_map_benchmark [--class SL] [--coaches 24] [--rounds 200] "
+                  << "[--legs 8] [--threads 4] [--seed 1]" << std::endl;
+        return 1;
+    }
+    
+    const CoachLayout& layout = SeatMapRegistry::layoutFor(options.classCode);
+    const int totalSeats = options.coaches * layout.seatsPerCoach;
+    std::mt19937_64 rng(options.seed);
+    long failures = 0;
+    
+    std::cout << std::fixed;
+    std::cout << "Class " << options.classCode << ", " << options.coaches << " coaches of "
+              << layout.seatsPerCoach << " (" << totalSeats << " seats), "
+              << options.rounds << " rounds" << std::endl;
+    
+    // Whole rake, one seat at a time from empty to full
+    {
+        SeatMap map(options.coaches, layout);
+        std::vector<SeatRef> seats;
+        seats.reserve(static_cast<size_t>(totalSeats));
+        long allocations = 0;
+        double seconds = 0.0;
+        for (int round = 0; round < options.rounds; round++) {
+            seats.clear();
+            auto started = std::chrono::steady_clock::now();
+            while (map.allocate(1, seats)) {}
+            seconds += secondsSince(started);
+            allocations += static_cast<long>(seats.size());
+            
+            std::vector<char> taken(static_cast<size_t>(totalSeats), 0);
+            if (static_cast<int>(seats.size()) != totalSeats ||
+                !markSeats(seats, layout.seatsPerCoach, taken)) {
+                failures++;
+            }
+            for (const auto& seat : seats) {
+                map.release(seat);
+            }
+        }
+        report("Fill", allocations, seconds);
+    }
+    
+    // A full rake with one seat coming free at a random spot each time
+    {
+        SeatMap map(options.coaches, layout);
+        std::vector<SeatRef> seats;
+        while (map.allocate(1, seats)) {}
+        std::uniform_int_distribution<size_t> pick(0, seats.size() - 1);
+        long allocations = static_cast<long>(options.rounds) * totalSeats;
+        std::vector<SeatRef> claimed;
+        
+        auto started = std::chrono::steady_clock::now();
+        for (long i = 0; i < allocations; i++) {
+            SeatRef& seat = seats[pick(rng)];
+            map.release(seat);
+            claimed.clear();
+            if (!map.allocate(1, claimed)) {
+                failures++;
+                break;
+            }
+            seat = claimed[0];
+        }
+        report("Last seat", allocations, secondsSince(started), "(release + allocate)");
+    }
+    
+    // Parties of 1-6, kept to a bay where one has room
+    {
+        SeatMap map(options.coaches, layout);
+        std::uniform_int_distribution<int> party(1, SeatMap::MAX_GROUP_SIZE);
+        std::vector<SeatRef> seats;
+        long allocations = 0, seated = 0;
+        double seconds = 0.0;
+        for (int round = 0; round < options.rounds; round++) {
+            seats.clear();
+            int refused = 0;
+            auto started = std::chrono::steady_clock::now();
+            while (refused < FULL_AFTER_FAILURES) {
+                if (map.allocateGroup(party(rng), seats)) {
+                    allocations++;
+                    refused = 0;
+                } else {
+                    refused++;
+                }
+            }
+            seconds += secondsSince(started);
+            seated += static_cast<long>(seats.size());
+            
+            std::vector<char> taken(static_cast<size_t>(totalSeats), 0);
+            if (!markSeats(seats, layout.seatsPerCoach, taken)) {
+                failures++;
+            }
+            for (const auto& seat : seats) {
+                map.release(seat);
+            }
+        }
+        std::ostringstream note;
+        note << std::fixed << "(" << std::setprecision(1) << 100.0 * seated / (static_cast<double>(totalSeats) * options.rounds)
+             << "% seated)";
+        report("Groups", allocations, seconds, note.str());
+    }
+    
+    // Single passengers between random stops on a multi-leg route
+    {
+        SeatMap map(options.coaches, layout, options.legs);
+        std::uniform_int_distribution<int> stop(0, options.legs);
+        std::vector<Segment> sold;
+        std::vector<SeatRef> seats;
+        long allocations = 0, attempts = 0, fresh = 0, legSeats = 0;
+        double seconds = 0.0;
+        for (int round = 0; round < options.rounds; round++) {
+            sold.clear();
+            int refused = 0;
+            auto started = std::chrono::steady_clock::now();
+            while (refused < FULL_AFTER_FAILURES) {
+                int from = stop(rng), to = stop(rng);
+                if (from == to) {
+                    continue;
+                }
+                if (from > to) {
+                    std::swap(from, to);
+                }
+                seats.clear();
+                int freshSeats = 0;
+                attempts++;
+                if (map.allocateSegment(from, to, 1, seats, freshSeats)) {
+                    sold.push_back({seats[0], from, to});
+                    fresh += freshSeats;
+                    legSeats += to - from;
+                    allocations++;
+                    refused = 0;
+                } else {
+                    refused++;
+                }
+            }
+            seconds += secondsSince(started);
+            
+            for (const auto& segment : sold) {
+                map.releaseSegment(segment.seat, segment.fromStop, segment.toStop);
+            }
+            if (map.countFreeSeats() != totalSeats) {
+                failures++;
+            }
+        }
+        std::ostringstream note;
+        note << std::fixed << "(" << options.legs << " legs, " << attempts - allocations
+             << " refused, " << std::setprecision(1)
+             << 100.0 * legSeats / (static_cast<double>(totalSeats) * options.legs * options.rounds)
+             << "% of seat-legs sold, " << 100.0 * (allocations - fresh) / allocations
+             << "% on part-sold seats)";
+        report("Segments", allocations, seconds, note.str());
+    }
+    
+    // Several threads filling one rake at once
+    {
+        long allocations = 0;
+        double seconds = 0.0;
+        for (int round = 0; round < options.rounds; round++) {
+            SeatMap map(options.coaches, layout);
+            std::vector<std::vector<SeatRef>> claimed(static_cast<size_t>(options.threads));
+            std::atomic<int> ready(0);
+            std::atomic<bool> go(false);
+            std::vector<std::thread> workers;
+            for (int t = 0; t < options.threads; t++) {
+                workers.emplace_back([&, t]() {
+                    std::vector<SeatRef>& mine = claimed[static_cast<size_t>(t)];
+                    mine.reserve(static_cast<size_t>(totalSeats));
+                    ready.fetch_add(1);
+                    while (!go.load(std::memory_order_acquire)) {
+                        std::this_thread::yield();
+                    }
+                    while (map.allocate(1, mine)) {}
+                });
+            }
+            while (ready.load() < options.threads) {
+                std::this_thread::yield();
+            }
+            
+            auto started = std::chrono::steady_clock::now();
+            go.store(true, std::memory_order_release);
+            for (auto& worker : workers) {
+                worker.join();
+            }
+            seconds += secondsSince(started);
+            
+            std::vector<char> taken(static_cast<size_t>(totalSeats), 0);
+            size_t total = 0;
+            bool distinct = true;
+            for (const auto& seats : claimed) {
+                total += seats.size();
+                distinct = markSeats(seats, layout.seatsPerCoach, taken) && distinct;
+            }
+            allocations += static_cast<long>(total);
+            if (!distinct || static_cast<int>(total) != totalSeats) {
+                failures++;
+            }
+        }
+        std::ostringstream note;
+        note << "(" << options.threads << " threads, one map)";
+        report("Concurrent fill", allocations, seconds, note.str());
+    }
+    
+    std::cout << "Check failures: " << failures << std::endl;
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,235 @@
+// Replays synthetic bookings and cancellations against SeatAllocationService
+// and reports allocation latency, fill rate, group splits and how often
+// berth preferences were met, so allocator changes can be compared on
+// numbers. Each journey date is booked until parties keep failing, with
+// cancellations mixed in, then the next date starts on a fresh seat map.
+//
+//   seat_simulator [--bookings N] [--class SL] [--coaches 18]
+//                  [--cancel 0.2] [--seed 1]
+
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <vector>
+#include <random>
+#include <chrono>
+#include <algorithm>
+#include <cstdint>
+#include "models/Passenger.h"
+#include "models/Train.h"
+#include "services/SeatAllocationService.h"
+#include "utils/DateUtils.h"
+#include "utils/SeatMap.h"
+
+namespace {
+
+struct Options {
+    long bookings = 1000000;
+    std::string classCode = "SL";
+    int coaches = 18;
+    double cancelRate = 0.2;
+    unsigned seed = 1;
+};
+
+// Party sizes 1-6 and berth choices, roughly as seen on reserved classes
+const double PARTY_WEIGHTS[] = {45, 25, 10, 10, 5, 5};
+const char* const PREFERENCES[] = {"No Choice", "Lower", "Middle", "Upper", "Side Lower", "Side Upper"};
+const double PREFERENCE_WEIGHTS[] = {50, 25, 5, 7, 9, 4};
+
+// Parties give up on a date after this many refusals in a row
+const int FULL_AFTER_FAILURES = 20;
+
+bool parseOptions(int argc, char* argv[], Options& options) {
+    for (int i = 1; i < argc; i++) {
+        std::string flag = argv[i];
+        if (i + 1 >= argc) {
+            std::cerr << "Missing value for " << flag << std::endl;
+            return false;
+        }
+        std::string value = argv[++i];
+        try {
+            if (flag == "--bookings") options.bookings = std::stol(value);
+            else if (flag == "--class") options.classCode = value;
+            else if (flag == "--coaches") options.coaches = std::stoi(value);
+            else if (flag == "--cancel") options.cancelRate = std::stod(value);
+            else if (flag == "--seed") options.seed = static_cast<unsigned>(std::stoul(value));
+            else {
+                std::cerr << "Unknown option " << flag << std::endl;
+                return false;
+            }
+        } catch (const std::exception&) {
+            std::cerr << "Invalid value for " << flag << ": " << value << std::endl;
+            return false;
+        }
+    }
+    
+    TravelClass travelClass;
+    if (!parseTravelClass(options.classCode, travelClass)) {
+        std::cerr << "Unknown class " << options.classCode << std::endl;
+        return false;
+    }
+    if (options.bookings < 1 || options.coaches < 1 ||
+        options.cancelRate < 0.0 || options.cancelRate >= 1.0) {
+        std::cerr << "bookings and coaches must be positive, cancel in [0, 1)" << std::endl;
+        return false;
+    }
+    return true;
+}
+
+bool parseSeat(const std::string& label, SeatRef& seat) {
+    size_t dash = label.find('-');
+    size_t digits = label.find_first_of("0123456789");
+    if (dash == std::string::npos || digits == std::string::npos || digits > dash) {
+        return false;
+    }
+    seat.coach = std::stoi(label.substr(digits, dash - digits));
+    seat.seat = std::stoi(label.substr(dash + 1));
+    return true;
+}
+
+// All in one bay of one coach
+bool seatedTogether(const std::vector<Passenger>& party, const CoachLayout& layout) {
+    SeatRef first;
+    if (!parseSeat(party[0].getAssignedSeat(), first)) {
+        return false;
+    }
+    for (const auto& passenger : party) {
+        SeatRef seat;
+        if (!parseSeat(passenger.getAssignedSeat(), seat) || seat.coach != first.coach ||
+            (seat.seat - 1) / layout.baySeats != (first.seat - 1) / layout.baySeats) {
+            return false;
+        }
+    }
+    return true;
+}
+
+uint64_t percentile(std::vector<uint64_t>& samples, double fraction) {
+    if (samples.empty()) {
+        return 0;
+    }
+    size_t index = std::min(samples.size() - 1, static_cast<size_t>(fraction * samples.size()));
+    std::nth_element(samples.begin(), samples.begin() + index, samples.end());
+    return samples[index];
+}
+
+}
+
+int main(int argc, char* argv[]) {
+    Options options;
+    if (!parseOptions(argc, argv, options)) {
+        std::cerr << "Usage: seat_simulator [--bookings N] [--class SL] [--coaches 18] "
+                  << "[--cancel 0.2] [--seed 1]" << std::endl;
+        return 1;
+    }
+    
+    const CoachLayout& layout = SeatMapRegistry::layoutFor(options.classCode);
+    bool hasBerths = layout.berthAt(1) != BerthType::Seat; // Chair cars offer no berth choice
+    int totalSeats = options.coaches * layout.seatsPerCoach;
+    
+    // Every seat free at the start; nothing sold before the run
+    Train train("00000", "Simulator Express");
+    train.addAvailability(TrainAvailability(options.classCode, totalSeats, totalSeats, 0.0));
+    
+    std::mt19937_64 rng(options.seed);
+    std::uniform_real_distribution<double> coin(0.0, 1.0);
+    std::discrete_distribution<int> partySize(std::begin(PARTY_WEIGHTS), std::end(PARTY_WEIGHTS));
+    std::discrete_distribution<int> preference(std::begin(PREFERENCE_WEIGHTS), std::end(PREFERENCE_WEIGHTS));
+    
+    SeatAllocationService seatService;
+    SeatMapRegistry* registry = SeatMapRegistry::getInstance();
+    
+    std::vector<uint64_t> latencies;
+    latencies.reserve(static_cast<size_t>(options.bookings));
+    long attempted = 0, confirmed = 0, cancelled = 0;
+    long groups = 0, groupsSplit = 0;
+    long openGroups = 0, openGroupsSplit = 0; // Parties with no berth choices
+    long preferenceAsked = 0, preferenceMet = 0;
+    double fillSum = 0.0;
+    int journeys = 0;
+    int firstDay = DateUtils::today();
+    
+    auto started = std::chrono::steady_clock::now();
+    while (attempted < options.bookings) {
+        std::string journeyDate = DateUtils::formatDate(firstDay + journeys);
+        std::vector<std::vector<Passenger>> live;
+        int failures = 0;
+        
+        while (failures < FULL_AFTER_FAILURES && attempted < options.bookings) {
+            if (!live.empty() && coin(rng) < options.cancelRate) {
+                size_t pick = rng() % live.size();
+                seatService.releaseSeats(live[pick], train, journeyDate, options.classCode);
+                live[pick] = std::move(live.back());
+                live.pop_back();
+                cancelled++;
+                continue;
+            }
+            
+            std::vector<Passenger> party;
+            int size = partySize(rng) + 1;
+            bool choseBerths = false;
+            for (int i = 0; i < size; i++) {
+                int choice = hasBerths ? preference(rng) : 0;
+                choseBerths = choseBerths || choice != 0;
+                party.emplace_back("Passenger", 30, "M", PREFERENCES[choice]);
+            }
+            
+            auto before = std::chrono::steady_clock::now();
+            bool seated = seatService.assignSeats(party, train, journeyDate, options.classCode);
+            auto after = std::chrono::steady_clock::now();
+            latencies.push_back(static_cast<uint64_t>(
+                std::chrono::duration_cast<std::chrono::nanoseconds>(after - before).count()));
+            attempted++;
+            
+            if (!seated) {
+                failures++;
+                continue;
+            }
+            failures = 0;
+            confirmed++;
+            
+            if (size > 1) {
+                bool split = !seatedTogether(party, layout);
+                groups++;
+                groupsSplit += split;
+                if (!choseBerths) {
+                    openGroups++;
+                    openGroupsSplit += split;
+                }
+            }
+            for (const auto& passenger : party) {
+                BerthType wanted;
+                if (parseBerthType(passenger.getBerthPreference(), wanted)) {
+                    preferenceAsked++;
+                    preferenceMet += passenger.getAssignedBerth() == berthTypeName(wanted);
+                }
+            }
+            live.push_back(std::move(party));
+        }
+        
+        SeatMap* map = registry->getMap(train, journeyDate, options.classCode);
+        fillSum += static_cast<double>(totalSeats - map->countFreeSeats()) / totalSeats;
+        journeys++;
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - started).count();
+    
+    auto rate = [](long part, long whole) { return whole > 0 ? 100.0 * part / whole : 0.0; };
+    std::cout << std::fixed << std::setprecision(2);
+    std::cout << "Class " << options.classCode << " (" << layout.id << "), " << options.coaches
+              << " coaches, " << totalSeats << " seats per journey" << std::endl;
+    std::cout << "Bookings attempted:   " << attempted << " over " << journeys << " journeys, "
+              << cancelled << " cancellations, " << seconds << " s" << std::endl;
+    std::cout << "Confirmed:            " << rate(confirmed, attempted) << "%" << std::endl;
+    std::cout << "Fill rate:            " << (journeys > 0 ? 100.0 * fillSum / journeys : 0.0)
+              << "% of seats taken when a journey stopped accepting parties" << std::endl;
+    std::cout << "Group split rate:     " << rate(groupsSplit, groups) << "% of "
+              << groups << " parties of 2+ not in one bay; "
+              << rate(openGroupsSplit, openGroups) << "% of the " << openGroups
+              << " without berth choices" << std::endl;
+    std::cout << "Preference satisfied: " << rate(preferenceMet, preferenceAsked) << "% of "
+              << preferenceAsked << " passengers who chose a berth" << std::endl;
+    std::cout << "Latency (ns):         p50 " << percentile(latencies, 0.50)
+              << "  p90 " << percentile(latencies, 0.90)
+              << "  p99 " << percentile(latencies, 0.99)
+              << "  p99.9 " << percentile(latencies, 0.999) << std::endl;
+    return 0;
+}
@@ -0,0 +1,251 @@
+// Measures RAC/waitlist promotion throughput during mass cancellations.
+// Every journey date is sold out and its RAC and waitlist queues filled,
+// then a share of the confirmed bookings is cancelled the way
+// BookingService does it: seats go back to the seat map and through
+// WaitlistManager::releaseSeats, which promotes queue heads in order via
+// BookingService::applyPromotion. Reports cancellations and promotions per
+// second, cancellation latency, and checks every confirmed booking holds
+// real seats afterwards. Exits non-zero if one does not.
+//
+//   waitlist_benchmark [--dates 40] [--class SL] [--cancel 0.5] [--seed 1]
+
+#include <iostream>
+#include <iomanip>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <random>
+#include <chrono>
+#include <algorithm>
+#include <cstdint>
+#include "models/Booking.h"
+#include "models/Passenger.h"
+#include "models/Train.h"
+#include "services/BookingService.h"
+#include "services/SeatAllocationService.h"
+#include "utils/DataStore.h"
+#include "utils/DateUtils.h"
+#include "utils/SeatInventory.h"
+#include "utils/SeatMap.h"
+#include "utils/WaitlistManager.h"
+
+namespace {
+
+struct Options {
+    int dates = 40;
+    std::string classCode = "SL";
+    double cancelRate = 0.5;
+    unsigned seed = 1;
+};
+
+struct Sold {
+    std::string bookingId;
+    std::vector<Passenger> passengers;
+};
+
+bool parseOptions(int argc, char* argv[], Options& options) {
+    for (int i = 1; i < argc; i++) {
+        std::string flag = argv[i];
+        if (i + 1 >= argc) {
+            std::cerr << "Missing value for " << flag << std::endl;
+            return false;
+        }
+        std::string value = argv[++i];
+        try {
+            if (flag == "--dates") options.dates = std::stoi(value);
+            else if (flag == "--class") options.classCode = value;
+            else if (flag == "--cancel") options.cancelRate = std::stod(value);
+            else if (flag == "--seed") options.seed = static_cast<unsigned>(std::stoul(value));
+            else {
+                std::cerr << "Unknown option " << flag << std::endl;
+                return false;
+            }
+        } catch (const std::exception&) {
+            std::cerr << "Invalid value for " << flag << ": " << value << std::endl;
+            return false;
+        }
+    }
+    
+    TravelClass travelClass;
+    if (!parseTravelClass(options.classCode, travelClass)) {
+        std::cerr << "Unknown class " << options.classCode << std::endl;
+        return false;
+    }
+    if (options.dates < 1 || options.cancelRate <= 0.0 || options.cancelRate > 1.0) {
+        std::cerr << "dates must be positive, cancel in (0, 1]" << std::endl;
+        return false;
+    }
+    return true;
+}
+
+uint64_t percentile(std::vector<uint64_t>& samples, double fraction) {
+    if (samples.empty()) {
+        return 0;
+    }
+    size_t index = std::min(samples.size() - 1, static_cast<size_t>(fraction * samples.size()));
+    std::nth_element(samples.begin(), samples.begin() + index, samples.end());
+    return samples[index];
+}
+
+bool hasRealSeats(const Booking& booking) {
+    for (const auto& passenger : booking.getPassengers()) {
+        const std::string seat = passenger.getAssignedSeat();
+        if (seat.empty() || seat.compare(0, 3, "WL ") == 0 || seat.compare(0, 4, "RAC ") == 0) {
+            return false;
+        }
+    }
+    return true;
+}
+
+}
+
+int main(int argc, char* argv[]) {
+    Options options;
+    if (!parseOptions(argc, argv, options)) {
+        std::cerr << "Usage: waitlist_benchmark [--dates 40] [--class SL] [--cancel 0.5] "
+                  << "[--seed 1]" << std::endl;
+        return 1;
+    }
+    
+    // The services log every booking; keep the report readable
+    std::ostringstream discarded;
+    std::streambuf* console = std::cout.rdbuf(discarded.rdbuf());
+    
+    DataStore* store = DataStore::getInstance();
+    const CoachLayout& layout = SeatMapRegistry::layoutFor(options.classCode);
+    int totalSeats = 18 * layout.seatsPerCoach;
+    
+    Train train("00000", "Benchmark Express");
+    train.setFromStation("Origin");
+    train.setToStation("Terminus");
+    train.addAvailability(TrainAvailability(options.classCode, totalSeats, totalSeats, 0.0));
+    store->addTrain(train);
+    
+    long promotedConfirmed = 0, promotedRac = 0, stalled = 0;
+    WaitlistManager* waitlist = WaitlistManager::getInstance();
+    waitlist->setPromotionHandler([&](const WaitlistPromotion& promotion) {
+        if (!BookingService::applyPromotion(promotion)) {
+            stalled++;
+            return false;
+        }
+        (promotion.tier == WaitlistTier::Confirmed ? promotedConfirmed : promotedRac)++;
+        return true;
+    });
+    
+    std::mt19937_64 rng(options.seed);
+    std::uniform_int_distribution<int> partySize(1, 4);
+    SeatAllocationService seatService;
+    long nextId = 0;
+    long queuedBookings = 0;
+    
+    // Sell out every date, then fill RAC and the waitlist behind it
+    std::vector<std::vector<Sold>> confirmed(static_cast<size_t>(options.dates));
+    std::vector<std::string> journeyDates;
+    for (int d = 0; d < options.dates; d++) {
+        std::string journeyDate = DateUtils::formatDate(DateUtils::today() + 30 + d);
+        journeyDates.push_back(journeyDate);
+        InventoryCounter* counter = SeatInventory::getInstance()->getCounter(
+            train, journeyDate, options.classCode);
+        
+        while (true) {
+            std::vector<Passenger> passengers;
+            int size = partySize(rng);
+            for (int i = 0; i < size; i++) {
+                passengers.emplace_back("Passenger", 30, "M", "No Choice");
+            }
+            
+            Booking booking("bench_user", train, options.classCode);
+            booking.setBookingId("bench_" + std::to_string(nextId++));
+            booking.setJourneyDate(journeyDate);
+            booking.setSegment(train.getFromStation(), train.getToStation());
+            
+            WaitlistTicket ticket{WaitlistTier::Confirmed, 0};
+            bool reserved = SeatInventory::tryReserve(counter, size);
+            if (!reserved) {
+                bool queued = waitlist->enqueue(
+                    train.getTrainNumber(), journeyDate, options.classCode, counter,
+                    booking.getBookingId(), size, ticket, [&](const WaitlistTicket& queuedTicket) {
+                        for (int i = 0; i < size; i++) {
+                            bool rac = queuedTicket.tier == WaitlistTier::RAC;
+                            passengers[i].setAssignedSeat((rac ? "RAC " : "WL ") +
+                                                          std::to_string(queuedTicket.number + i));
+                        }
+                        booking.setPassengers(passengers);
+                        booking.setStatus(queuedTicket.tier == WaitlistTier::RAC ? "RAC" : "Waitlisted");
+                        store->addBooking(booking);
+                    });
+                if (!queued) {
+                    break; // RAC and waitlist full
+                }
+                if (ticket.tier != WaitlistTier::Confirmed) {
+                    queuedBookings++;
+                    continue;
+                }
+            }
+            
+            if (!seatService.assignSeats(passengers, train, journeyDate, options.classCode)) {
+                SeatInventory::release(counter, size);
+                break;
+            }
+            booking.setPassengers(passengers);
+            booking.setStatus("Confirmed");
+            store->addBooking(booking);
+            confirmed[d].push_back({booking.getBookingId(), passengers});
+        }
+        
+        std::shuffle(confirmed[d].begin(), confirmed[d].end(), rng);
+    }
+    
+    // Mass cancellation, date by date, as cancelBooking releases seats
+    std::vector<uint64_t> latencies;
+    long cancellations = 0;
+    auto started = std::chrono::steady_clock::now();
+    for (int d = 0; d < options.dates; d++) {
+        const std::string& journeyDate = journeyDates[d];
+        InventoryCounter* counter = SeatInventory::getInstance()->getCounter(
+            train, journeyDate, options.classCode);
+        size_t cancelCount = static_cast<size_t>(confirmed[d].size() * options.cancelRate);
+        
+        for (size_t i = 0; i < cancelCount; i++) {
+            const Sold& sold = confirmed[d][i];
+            auto before = std::chrono::steady_clock::now();
+            store->modifyBooking(sold.bookingId, [](Booking& booking) {
+                booking.setStatus("Cancelled");
+            });
+            seatService.releaseSeats(sold.passengers, train, journeyDate, options.classCode);
+            waitlist->releaseSeats(train.getTrainNumber(), journeyDate, options.classCode, counter,
+                                   static_cast<int>(sold.passengers.size()));
+            auto after = std::chrono::steady_clock::now();
+            latencies.push_back(static_cast<uint64_t>(
+                std::chrono::duration_cast<std::chrono::nanoseconds>(after - before).count()));
+            cancellations++;
+        }
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - started).count();
+    
+    long confirmedWithoutSeats = 0;
+    store->forEachBooking([&](const Booking& booking) {
+        if (booking.getStatus() == "Confirmed" && booking.getUserId() == "bench_user" &&
+            !hasRealSeats(booking)) {
+            confirmedWithoutSeats++;
+        }
+    });
+    
+    std::cout.rdbuf(console);
+    
+    long promotions = promotedConfirmed + promotedRac;
+    std::cout << std::fixed << std::setprecision(0);
+    std::cout << "Class " << options.classCode << ", " << totalSeats << " seats on each of "
+              << options.dates << " dates, " << queuedBookings << " bookings queued in RAC/WL" << std::endl;
+    std::cout << "Cancellations:   " << cancellations << " in " << std::setprecision(3) << seconds
+              << " s (" << std::setprecision(0) << cancellations / seconds << "/s)" << std::endl;
+    std::cout << "Promotions:      " << promotions << " (" << promotions / seconds << "/s): "
+              << promotedConfirmed << " to confirmed, " << promotedRac << " WL to RAC, "
+              << stalled << " left queued" << std::endl;
+    std::cout << "Latency (ns):    p50 " << percentile(latencies, 0.50)
+              << "  p90 " << percentile(latencies, 0.90)
+              << "  p99 " << percentile(latencies, 0.99)
+              << "  max " << percentile(latencies, 1.0) << std::endl;
+    std::cout << "Confirmed without seats: " << confirmedWithoutSeats << std::endl;
+    return confirmedWithoutSeats == 0 ? 0 : 1;
+}